@@ -0,0 +1,201 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Benchmark runner: runs every registered benchmark (or those whose name
+// contains --filter), prints a table, and optionally writes the results as
+// JSON (--json FILE) or compares them with an earlier JSON file
+// (--compare FILE) so runs can be diffed across commits.
+
+namespace {
+
+struct Benchmark {
+    std::string name;
+    BenchFn fn;
+};
+
+std::vector<Benchmark> &registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Result {
+    std::string name;
+    uint64_t iterations     = 0;
+    double ns_per_iter      = 0.0;
+    double items_per_second = 0.0;
+    std::string error;
+};
+
+struct RunnerOptions {
+    std::string filter;
+    std::string json_path;
+    std::string compare_path;
+    double min_time_s = 0.1; // per repetition
+    int repetitions   = 3;   // the fastest repetition is reported
+};
+
+bool parse_runner_args(RunnerOptions &options, int argc, char **argv) {
+    try {
+        for (int i = 1; i + 1 < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) continue;
+            const std::string value = argv[++i];
+            if (arg == "--filter") options.filter = value;
+            else if (arg == "--json") options.json_path = value;
+            else if (arg == "--compare") options.compare_path = value;
+            else if (arg == "--min-time") options.min_time_s = std::stod(value);
+            else if (arg == "--repetitions") options.repetitions = std::max(1, std::stoi(value));
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Grows the iteration count until one run takes min_time, then keeps the
+// fastest of `repetitions` runs at that count
+Result run_benchmark(const Benchmark &bench, const RunnerOptions &options) {
+    Result result;
+    result.name = bench.name;
+
+    uint64_t iterations = 1;
+    for (;;) {
+        BenchState state(iterations);
+        bench.fn(state);
+        if (!state.error().empty()) {
+            result.error = state.error();
+            return result;
+        }
+        const double min_ns = options.min_time_s * 1e9;
+        if (state.elapsed_ns() >= min_ns || iterations >= (uint64_t{ 1 } << 40)) break;
+
+        // Aim 40% past the target so the next attempt usually suffices
+        const double scale = state.elapsed_ns() > 0.0 ? 1.4 * min_ns / state.elapsed_ns() : 100.0;
+        iterations         = static_cast<uint64_t>(static_cast<double>(iterations) * std::min(scale, 100.0)) + 1;
+    }
+
+    double best_ns = 0.0, items = 0.0;
+    for (int rep = 0; rep < options.repetitions; ++rep) {
+        BenchState state(iterations);
+        bench.fn(state);
+        const double ns = state.elapsed_ns() / static_cast<double>(iterations);
+        if (rep == 0 || ns < best_ns) best_ns = ns;
+        items = state.items_per_iteration();
+    }
+
+    result.iterations       = iterations;
+    result.ns_per_iter      = best_ns;
+    result.items_per_second = items > 0.0 && best_ns > 0.0 ? items * 1e9 / best_ns : 0.0;
+    return result;
+}
+
+// Reads ns_per_iter back from a file written by write_json (one benchmark per line)
+std::map<std::string, double> read_baseline(const std::string &path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: cannot read baseline \"" << path << "\".\n";
+        return baseline;
+    }
+
+    const std::string name_key = "\"name\": \"", ns_key = "\"ns_per_iter\": ";
+    std::string line;
+    while (std::getline(file, line)) {
+        const std::size_t n  = line.find(name_key);
+        const std::size_t ns = line.find(ns_key);
+        if (n == std::string::npos || ns == std::string::npos) continue;
+        const std::size_t name_start = n + name_key.size();
+        const std::string name       = line.substr(name_start, line.find('"', name_start) - name_start);
+        baseline[name]               = std::atof(line.c_str() + ns + ns_key.size());
+    }
+    return baseline;
+}
+
+bool write_json(const std::string &path, const std::vector<Result> &results) {
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error: cannot write \"" << path << "\".\n";
+        return false;
+    }
+
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    std::fprintf(file, "{\n  \"context\": {\n");
+    std::fprintf(file, "    \"date\": \"%s\",\n", date);
+    std::fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#ifdef __OPTIMIZE__
+    std::fprintf(file, "    \"optimized\": true,\n");
+#else
+    std::fprintf(file, "    \"optimized\": false,\n");
+#endif
+    std::fprintf(file, "    \"host_threads\": %u\n  },\n", std::thread::hardware_concurrency());
+
+    std::fprintf(file, "  \"benchmarks\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        if (r.error.empty())
+            std::fprintf(file,
+                         "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_iter\": %.3f, "
+                         "\"items_per_second\": %.1f}",
+                         r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_iter,
+                         r.items_per_second);
+        else
+            std::fprintf(file, "    {\"name\": \"%s\", \"error\": \"%s\"}", r.name.c_str(), r.error.c_str());
+        std::fprintf(file, "%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+void register_benchmark(std::string name, BenchFn fn) {
+    registry().push_back({ std::move(name), std::move(fn) });
+}
+
+int main(int argc, char **argv) {
+    RunnerOptions options;
+    if (!parse_runner_args(options, argc, argv))
+        return EXIT_FAILURE;
+
+    std::map<std::string, double> baseline;
+    if (!options.compare_path.empty()) baseline = read_baseline(options.compare_path);
+
+    std::printf("%-44s %14s %16s%s\n", "benchmark", "ns/iter", "items/s", baseline.empty() ? "" : "   vs base");
+
+    std::vector<Result> results;
+    bool failed = false;
+    for (const Benchmark &bench : registry()) {
+        if (bench.name.find(options.filter) == std::string::npos) continue;
+
+        const Result r = run_benchmark(bench, options);
+        results.push_back(r);
+        if (!r.error.empty()) {
+            std::printf("%-44s ERROR: %s\n", r.name.c_str(), r.error.c_str());
+            failed = true;
+            continue;
+        }
+
+        std::printf("%-44s %14.2f %16.0f", r.name.c_str(), r.ns_per_iter, r.items_per_second);
+        if (const auto it = baseline.find(r.name); it != baseline.end() && r.ns_per_iter > 0.0)
+            std::printf("   %7.2fx", it->second / r.ns_per_iter); // > 1 is faster than the baseline
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    if (!options.json_path.empty() && !write_json(options.json_path, results)) failed = true;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
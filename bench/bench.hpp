@@ -0,0 +1,84 @@
+#ifndef BENCH_H__
+#define BENCH_H__
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+// A minimal Google-Benchmark-style harness. Benchmarks register a function
+// that runs its timed section as
+//     for (auto _ : state) { ... }
+// and the runner grows the iteration count until a run lasts long enough to
+// time reliably. Setup before the loop is not timed.
+class BenchState {
+public:
+    explicit BenchState(uint64_t iterations) : iterations_(iterations) {}
+
+    struct [[maybe_unused]] Value {}; // what `auto _` binds to; never warned about
+
+    struct Iterator {
+        BenchState *state;
+        uint64_t left;
+
+        bool operator!=(const Iterator &) {
+            if (left != 0) return true;
+            state->stop();
+            return false;
+        }
+        void operator++() { --left; }
+        Value operator*() const { return {}; }
+    };
+
+    Iterator begin() {
+        start_ = std::chrono::steady_clock::now();
+        return { this, iterations_ };
+    }
+    Iterator end() { return { this, 0 }; }
+
+    uint64_t iterations() const { return iterations_; }
+
+    // Work done per iteration, reported as a rate (instructions, frames, ...)
+    void set_items_per_iteration(double items) { items_per_iteration_ = items; }
+
+    // Marks the benchmark as failed; the runner reports `message` and moves on
+    void skip_with_error(std::string message) { error_ = std::move(message); }
+
+    double items_per_iteration() const { return items_per_iteration_; }
+    const std::string &error() const { return error_; }
+    double elapsed_ns() const { return elapsed_ns_; }
+
+private:
+    uint64_t iterations_;
+    double items_per_iteration_ = 0.0;
+    std::string error_;
+    std::chrono::steady_clock::time_point start_{};
+    double elapsed_ns_ = 0.0;
+
+    void stop() {
+        elapsed_ns_ = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+    }
+};
+
+using BenchFn = std::function<void(BenchState &)>;
+
+void register_benchmark(std::string name, BenchFn fn);
+
+// Registers benchmarks at static-initialisation time:
+//     BENCH_REGISTER(my_suite) { register_benchmark("a", ...); }
+#define BENCH_REGISTER(suite)                                    \
+    static void bench_register_##suite();                        \
+    static const bool bench_registered_##suite = [] {            \
+        bench_register_##suite();                                \
+        return true;                                             \
+    }();                                                         \
+    static void bench_register_##suite()
+
+// Keeps a value alive so the optimiser cannot drop the work producing it
+template <typename T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
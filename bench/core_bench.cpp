@@ -0,0 +1,255 @@
+#include "../include/chip8.hpp"
+#include "../include/run_ahead.hpp"
+#include "../include/scheduler.hpp"
+#include "bench.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Core benchmarks: interpreter throughput per opcode family, DXYN cost by
+// sprite height and position, ROM load time, whole frames of real ROMs
+// on each engine, and those frames with run-ahead on top.
+
+namespace {
+
+// A synthetic ROM in the temp directory, removed when it goes out of scope
+class TempRom {
+public:
+    explicit TempRom(const std::vector<uint8_t> &bytes) {
+        static int counter = 0;
+        path_ = (std::filesystem::temp_directory_path() / ("chip8-bench-" + std::to_string(counter++) + ".ch8")).string();
+        std::ofstream(path_, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()),
+                                                     static_cast<std::streamsize>(bytes.size()));
+    }
+    ~TempRom() { std::remove(path_.c_str()); }
+
+    TempRom(const TempRom &)            = delete;
+    TempRom &operator=(const TempRom &) = delete;
+
+    const std::string &path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+void put_op(std::vector<uint8_t> &rom, uint16_t opcode) {
+    rom.push_back(static_cast<uint8_t>(opcode >> 8));
+    rom.push_back(static_cast<uint8_t>(opcode));
+}
+
+// ---------------------------------------------------------------------------
+// Opcode families
+// ---------------------------------------------------------------------------
+// Each ROM points I at scratch RAM (0x800), then loops over BODY copies of
+// one instruction closed by a jump, so the family dominates the mix.
+constexpr int BODY = 64;
+
+struct Family {
+    const char *name;
+    uint16_t opcode;
+};
+
+constexpr Family FAMILIES[] = {
+    { "00E0_cls", 0x00E0 },      { "3XNN_skip", 0x3001 },       { "6XNN_load", 0x6A42 },
+    { "7XNN_add", 0x7A01 },      { "8XY0_move", 0x8AB0 },       { "8XY4_add_carry", 0x8AB4 },
+    { "8XY6_shift", 0x8AB6 },    { "9XY0_skip", 0x9AB0 },       { "ANNN_set_i", 0xA800 },
+    { "CXNN_rand", 0xCAFF },     { "DXYN_draw", 0xDAB5 },       { "EX9E_key", 0xEA9E },
+    { "FX07_timer", 0xFA07 },    { "FX1E_add_i", 0xF01E },      { "FX29_font", 0xFA29 },
+    { "FX33_bcd", 0xFA33 },      { "FX55_store", 0xF755 },      { "FX65_load", 0xF765 },
+};
+
+std::vector<uint8_t> family_rom(uint16_t opcode) {
+    std::vector<uint8_t> rom;
+    put_op(rom, 0xA800); // 0x200: I = 0x800
+    for (int i = 0; i < BODY; ++i) put_op(rom, opcode);
+    put_op(rom, 0x1202); // back to the body
+    return rom;
+}
+
+// Items are instructions; one iteration executes one
+void bench_opcode(BenchState &state, uint16_t opcode) {
+    const TempRom rom(family_rom(opcode));
+    Chip8 chip8(rom.path());
+    chip8.seed_rng(1);
+    const Config config;
+
+    for (auto _ : state) chip8.emulate_instruction(config);
+    do_not_optimize(chip8.display_hash());
+    state.set_items_per_iteration(1.0);
+}
+
+// Call and return alternate, so they are measured as a pair
+void bench_call_return(BenchState &state) {
+    std::vector<uint8_t> rom;
+    put_op(rom, 0x2204); // 0x200: call 0x204
+    put_op(rom, 0x1200); // 0x202: loop
+    put_op(rom, 0x00EE); // 0x204: return
+
+    const TempRom file(rom);
+    Chip8 chip8(file.path());
+    const Config config;
+
+    for (auto _ : state) chip8.emulate_instruction(config);
+    state.set_items_per_iteration(1.0);
+}
+
+// ---------------------------------------------------------------------------
+// DXYN
+// ---------------------------------------------------------------------------
+struct DrawPosition {
+    const char *name;
+    uint8_t x, y;
+};
+
+constexpr DrawPosition POSITIONS[] = {
+    { "origin", 0, 0 },        // word-aligned, fully on screen
+    { "unaligned", 37, 9 },    // straddles two bytes of the row
+    { "wrapped", 101, 40 },    // start coordinates wrap to (37, 8)
+    { "clip_right", 60, 10 },  // four columns cut off
+    { "clip_bottom", 10, 28 }, // rows past the bottom skipped
+};
+
+// V0/V1 = position, I = a 15-row sprite stored after the code, then the
+// draw repeats forever: one iteration is one DXYN plus the jump back.
+void bench_draw(BenchState &state, DrawPosition pos, uint8_t height) {
+    std::vector<uint8_t> rom;
+    put_op(rom, static_cast<uint16_t>(0x6000 | pos.x));    // 0x200
+    put_op(rom, static_cast<uint16_t>(0x6100 | pos.y));    // 0x202
+    put_op(rom, 0xA20A);                                    // 0x204: I = sprite
+    put_op(rom, static_cast<uint16_t>(0xD010 | height));   // 0x206
+    put_op(rom, 0x1206);                                    // 0x208
+    for (int row = 0; row < 15; ++row) rom.push_back(static_cast<uint8_t>(0xA5 ^ (row * 0x11))); // 0x20A
+
+    const TempRom file(rom);
+    Chip8 chip8(file.path());
+    const Config config;
+    chip8.run(config, 3); // setup
+
+    for (auto _ : state) chip8.run(config, 2);
+    do_not_optimize(chip8.display_hash());
+    state.set_items_per_iteration(1.0); // draws
+}
+
+// ---------------------------------------------------------------------------
+// Whole ROMs
+// ---------------------------------------------------------------------------
+struct RomCase {
+    const char *name;
+    const char *path;
+};
+
+constexpr RomCase ROMS[] = {
+    { "pong", "roms/games/Pong [Paul Vervalin, 1990].ch8" },
+    { "brix", "roms/games/Breakout (Brix hack) [David Winter, 1997].ch8" },
+    { "tetris", "roms/games/Tetris [Fran Dachille, 1991].ch8" },
+    { "invaders", "roms/games/Space Invaders [David Winter].ch8" },
+    { "ibm_logo", "roms/programs/IBM Logo.ch8" },
+};
+
+// Construction includes reading the file, the fontset and a full reset
+void bench_rom_load(BenchState &state, const char *path) {
+    if (!std::filesystem::exists(path)) {
+        state.skip_with_error(std::string("missing ") + path + " (run from the repository root)");
+        return;
+    }
+    for (auto _ : state) {
+        Chip8 chip8(path);
+        do_not_optimize(chip8.rom_hash());
+    }
+    state.set_items_per_iteration(1.0);
+}
+
+// One iteration is one 60 Hz frame as the headless runner does it: the
+// frame's instructions, a timer tick and the audio for the frame
+void bench_frames(BenchState &state, const char *path, Engine engine) {
+    if (!std::filesystem::exists(path)) {
+        state.skip_with_error(std::string("missing ") + path + " (run from the repository root)");
+        return;
+    }
+
+    Config config;
+    config.engine = engine;
+    Chip8 chip8(path);
+    chip8.seed_rng(1);
+    Scheduler scheduler(config.insts_per_second);
+    std::vector<int16_t> audio(config.audio_sample_rate / Scheduler::FRAME_HZ + 1);
+
+    for (auto _ : state) {
+        chip8.run(config, scheduler.instructions_for_frame());
+        chip8.update_timers();
+        do_not_optimize(chip8.render_audio(config, audio.data(), audio.size()));
+    }
+    state.set_items_per_iteration(1.0); // frames
+}
+
+// A frame as above, plus what run-ahead adds to it: a snapshot, `ahead`
+// speculative frames and the restore
+void bench_run_ahead(BenchState &state, const char *path, uint32_t ahead) {
+    if (!std::filesystem::exists(path)) {
+        state.skip_with_error(std::string("missing ") + path + " (run from the repository root)");
+        return;
+    }
+
+    Config config;
+    Chip8 chip8(path);
+    chip8.seed_rng(1);
+    Scheduler scheduler(config.insts_per_second);
+    RunAhead run_ahead(ahead);
+    SaveState snapshot;
+    std::vector<int16_t> audio(config.audio_sample_rate / Scheduler::FRAME_HZ + 1);
+
+    for (auto _ : state) {
+        chip8.run(config, scheduler.instructions_for_frame());
+        chip8.update_timers();
+        do_not_optimize(chip8.render_audio(config, audio.data(), audio.size()));
+        chip8.save_state(snapshot);
+        run_ahead.speculate(chip8, config, scheduler);
+        do_not_optimize(chip8.display_hash());
+        run_ahead.restore(chip8, snapshot);
+    }
+    state.set_items_per_iteration(1.0); // frames
+}
+
+} // namespace
+
+BENCH_REGISTER(core) {
+    for (const Family &family : FAMILIES) {
+        const uint16_t opcode = family.opcode;
+        register_benchmark(std::string("opcode/") + family.name,
+                           [=](BenchState &state) { bench_opcode(state, opcode); });
+    }
+    register_benchmark("opcode/2NNN_00EE_call_return", bench_call_return);
+
+    for (const DrawPosition &pos : POSITIONS) {
+        for (const uint8_t height : { 1, 5, 8, 15 }) {
+            register_benchmark("dxyn/" + std::string(pos.name) + "/" + std::to_string(height),
+                               [=](BenchState &state) { bench_draw(state, pos, height); });
+        }
+    }
+
+    for (const RomCase &rom : ROMS) {
+        const char *path = rom.path;
+        register_benchmark(std::string("rom_load/") + rom.name, [=](BenchState &state) { bench_rom_load(state, path); });
+    }
+
+    static const char *const ENGINE_NAMES[] = { "interpreter", "block", "jit" };
+    for (const RomCase &rom : ROMS) {
+        for (const Engine engine : { Engine::INTERPRETER, Engine::BLOCK, Engine::JIT }) {
+            const char *path = rom.path;
+            register_benchmark(std::string("frames/") + rom.name + "/" + ENGINE_NAMES[engine],
+                               [=](BenchState &state) { bench_frames(state, path, engine); });
+        }
+    }
+
+    for (const RomCase &rom : ROMS) {
+        for (const uint32_t ahead : { 1u, 2u }) {
+            const char *path = rom.path;
+            register_benchmark(std::string("run_ahead/") + rom.name + "/" + std::to_string(ahead),
+                               [=](BenchState &state) { bench_run_ahead(state, path, ahead); });
+        }
+    }
+}
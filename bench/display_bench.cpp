@@ -0,0 +1,58 @@
+#include "../include/chip8.hpp"
+#include "../include/display.hpp"
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Display::update_screen plus present, with and without pixel outlines, on
+// SDL's offscreen driver. Only built when SDL is available.
+
+namespace {
+
+constexpr const char *ROM = "roms/games/Breakout (Brix hack) [David Winter, 1997].ch8";
+
+// "dirty": every row the game touched stays dirty, so each frame converts
+// and uploads them all. "idle": nothing changed and the fade has settled,
+// so a frame is just the copy and present.
+void bench_update_screen(BenchState &state, bool outlines, bool dirty) {
+    if (!std::filesystem::exists(ROM)) {
+        state.skip_with_error(std::string("missing ") + ROM + " (run from the repository root)");
+        return;
+    }
+    setenv("SDL_VIDEODRIVER", "offscreen", 0);
+
+    Config config;
+    config.pixel_outlines = outlines;
+    static std::unique_ptr<Display> display; // one window for the whole suite
+    if (!display) display = std::make_unique<Display>(config);
+
+    Chip8 chip8(ROM);
+    chip8.seed_rng(1);
+    chip8.run(config, 2000); // a screen's worth of bricks
+
+    if (!dirty) {
+        for (int i = 0; i < 64; ++i) display->update_screen(config, chip8.get_display()); // let the fade settle
+        chip8.clear_dirty_rows();
+    }
+
+    for (auto _ : state) {
+        display->update_screen(config, chip8.get_display());
+        display->present();
+    }
+    state.set_items_per_iteration(1.0); // frames
+}
+
+} // namespace
+
+BENCH_REGISTER(display) {
+    for (const bool outlines : { false, true }) {
+        for (const bool dirty : { true, false }) {
+            register_benchmark(std::string("display/update_screen/") + (outlines ? "outlines" : "no_outlines") +
+                                   (dirty ? "/dirty" : "/idle"),
+                               [=](BenchState &state) { bench_update_screen(state, outlines, dirty); });
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "../include/fade.hpp"
+#include "bench.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Phosphor fade over a whole framebuffer's worth of pixels, comparing the
+// old per-pixel float color_lerp with the fixed-point kernels.
+
+static constexpr uint32_t FG = 0xFFFFFFFF;
+static constexpr uint32_t BG = 0x000000FF;
+static constexpr float RATE  = 0.7f;
+
+// The pre-kernel Display::color_lerp, kept verbatim as the baseline
+static uint32_t color_lerp(uint32_t start_color, uint32_t end_color, float t) {
+    const auto lerp_channel = [t](uint8_t s, uint8_t e) -> uint8_t {
+        return static_cast<uint8_t>((1.0f - t) * s + t * e);
+    };
+
+    const uint8_t r = lerp_channel((start_color >> 24) & 0xFF, (end_color >> 24) & 0xFF);
+    const uint8_t g = lerp_channel((start_color >> 16) & 0xFF, (end_color >> 16) & 0xFF);
+    const uint8_t b = lerp_channel((start_color >> 8) & 0xFF, (end_color >> 8) & 0xFF);
+    const uint8_t a = lerp_channel((start_color >> 0) & 0xFF, (end_color >> 0) & 0xFF);
+
+    return (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16) | (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(a);
+}
+
+static bool fade_float(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t) {
+    bool fading = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (colors[i] != targets[i]) colors[i] = color_lerp(colors[i], targets[i], RATE);
+        fading |= colors[i] != targets[i];
+    }
+    return fading;
+}
+
+using FadeFn = bool (*)(uint32_t *, const uint32_t *, std::size_t, uint8_t);
+
+// The SIMD and scalar kernels must agree bit for bit
+static bool kernels_agree() {
+    std::vector<uint32_t> c1(4099), c2(4099), t(4099);
+    for (std::size_t i = 0; i < t.size(); ++i) {
+        c1[i] = c2[i] = static_cast<uint32_t>(i * 2654435761u);
+        t[i]          = static_cast<uint32_t>(i * 40503u + 17u);
+    }
+    for (int step = 0; step < 12; ++step) {
+        fade_span(c1.data(), t.data(), t.size(), fade_weight(RATE));
+        fade_span_scalar(c2.data(), t.data(), t.size(), fade_weight(RATE));
+    }
+    return c1 == c2;
+}
+
+// Alternates between two target images every few frames so pixels are
+// always mid-fade ("active"), or keeps colors at their targets ("settled").
+// One iteration fades one frame; items are pixels.
+static void bench_fade(BenchState &state, FadeFn fn, std::size_t n, bool settled) {
+    if (fn != fade_float && !kernels_agree()) {
+        state.skip_with_error("fade kernels disagree");
+        return;
+    }
+
+    std::vector<uint32_t> colors(n, BG), a(n), b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = ((i * 7) % 3 == 0) ? FG : BG;
+        b[i] = ((i * 5) % 4 == 0) ? FG : BG;
+    }
+    if (settled) colors = a;
+
+    const uint8_t weight = fade_weight(RATE);
+    uint64_t frame       = 0;
+    for (auto _ : state) {
+        const std::vector<uint32_t> &targets = (settled || (frame++ / 4) % 2 == 0) ? a : b;
+        do_not_optimize(fn(colors.data(), targets.data(), n, weight));
+    }
+    state.set_items_per_iteration(static_cast<double>(n));
+}
+
+BENCH_REGISTER(fade) {
+    struct Case {
+        const char *name;
+        FadeFn fn;
+    };
+    static const Case cases[] = {
+        { "float_color_lerp", fade_float },
+        { "fixed_scalar", fade_span_scalar },
+        { "fixed_simd", fade_span },
+    };
+
+    for (const std::size_t n : { std::size_t{ 64 * 32 }, std::size_t{ 128 * 64 } }) {
+        for (const bool settled : { false, true }) {
+            for (const Case &c : cases) {
+                const FadeFn fn = c.fn;
+                register_benchmark("fade/" + std::string(c.name) + "/" + std::to_string(n) +
+                                       (settled ? "/settled" : "/active"),
+                                   [=](BenchState &state) { bench_fade(state, fn, n, settled); });
+            }
+        }
+    }
+}
@@ -2,7 +2,15 @@
 #define AUDIO_H__
 
 #include "config.hpp"
+#include "ring_buffer.hpp"
 #include <SDL2/SDL_audio.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// SDL audio sink. The emulation thread pushes ready-made samples into a
+// lock-free ring; the SDL callback only copies them out, so it never
+// touches Config or emulator state and the device is never paused.
 class Audio {
 public:
     explicit Audio(const Config &config);
@@ -12,14 +20,20 @@ public:
     Audio(const Audio &) = delete;
     Audio &operator=(const Audio &) = delete;
 
-    void play();
-    void stop();
+    // Emulation thread: queue samples; returns how many fit
+    std::size_t push(const int16_t *samples, std::size_t count);
+
+    // Callbacks that found the ring short of samples
+    uint64_t underruns() const { return underruns_.load(std::memory_order_relaxed); }
 
 private:
     SDL_AudioSpec want_{};
     SDL_AudioSpec have_{};
     SDL_AudioDeviceID dev_ = 0;
 
+    SpscRing<int16_t, 8192> ring_;
+    std::atomic<uint64_t> underruns_{ 0 };
+
     static void audioCallback(void *userdata, Uint8 *stream, int len);
 };
 
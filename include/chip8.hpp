@@ -1,14 +1,22 @@
 #ifndef CHIP8_H__
 #define CHIP8_H__
 
-#include "audio.hpp"
 #include "config.hpp"
+#include "framebuffer.hpp"
+#include "instruction.hpp"
+#include "jit.hpp"
+#include "perf.hpp"
+#include "rom_library.hpp"
+#include "savestate.hpp"
+#include "trace.hpp"
 
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 enum class EmulatorState {
     QUIT,
@@ -16,40 +24,72 @@ enum class EmulatorState {
     PAUSED
 };
 
-struct Instruction {
-    uint16_t opcode = 0;
-    uint16_t NNN    = 0; // 12-bit address / constant
-    uint8_t NN      = 0; // 8-bit constant
-    uint8_t N       = 0; // 4-bit constant
-    uint8_t X       = 0; // 4-bit register index
-    uint8_t Y       = 0; // 4-bit register index
-};
-
 class Chip8 {
 public:
-    explicit Chip8(const std::string &rom_path, Audio &audio);
+    explicit Chip8(const std::string &rom_path);
+    explicit Chip8(std::shared_ptr<const RomImage> rom); // nullptr: nothing loaded, state QUIT
 
     // Main interface
     void emulate_instruction(const Config &config);
-    void handle_input(Config &config);
+    void run(const Config &config, uint32_t count); // `count` instructions back to back, idle loops skipped
     void update_timers();
     void reset();
 
+    // Save states — restoring only invalidates cached code for RAM bytes that
+    // actually differ, so stepping between nearby states stays cheap. A state
+    // that is not valid() is refused and the machine left as it was.
+    void save_state(SaveState &state) const;
+    bool load_state(const SaveState &state);
+
+    // Input — fed by a frontend; the core never polls the host itself
+    void set_key(uint8_t key, bool pressed) { keypad_[key & 0x0F] = pressed; }
+    void toggle_pause();
+    void quit() { state_ = EmulatorState::QUIT; }
+
+    // Reseeds CXNN's generator, making a run reproducible
+    void seed_rng(uint32_t seed) {
+        rng_.seed(seed);
+        rand_byte_.reset();
+    }
+
     // Accessors
     EmulatorState get_state() const { return state_; }
     bool get_draw_flag() const { return draw_; }
     void set_draw_flag(bool v) { draw_ = v; }
-
-    const std::array<bool, 64 * 32> &get_display() const { return display_; }
-
-#ifdef DEBUG
-    void print_debug_info() const;
-#endif
+    bool is_beeping() const { return beeping_; } // sound timer was active on the last tick
+    uint16_t keypad_mask() const;                 // bit k set while key k is held
+    uint64_t rom_hash() const { return rom_hash_; } // FNV-1a of the ROM image
+
+    // Audio — renders one 60 Hz frame of beeper output at config.audio_sample_rate
+    // into `out`; returns the number of samples written (at most `capacity`)
+    std::size_t render_audio(const Config &config, int16_t *out, std::size_t capacity);
+
+    // Performance counters; the core fills in the instruction and sprite
+    // counts, frontends the rest. The block engine and JIT count whole block
+    // runs, so op_class is only brought up to date by calling perf().
+    // With config.profile_path set, run() also counts executions per
+    // address (on the interpreter, whatever the engine).
+    PerfCounters &perf();
+    const std::vector<uint64_t> &pc_profile() const { return pc_profile_; } // empty unless profiling
+
+    // Execution tracing, switchable at any time; nullptr turns it off. While
+    // a tracer is attached run() uses the interpreter, whatever the engine.
+    void set_tracer(Tracer *tracer) {
+        tracer_    = tracer;
+        trace_seq_ = 0;
+    }
+
+    const FrameBuffer &get_display() const { return display_; }
+    void clear_dirty_rows() { display_.clear_dirty(); } // frontend has consumed the changed rows
+    uint64_t display_hash() const; // FNV-1a over the framebuffer, for golden comparisons
 
 private:
-    static constexpr std::size_t RAM_SIZE   = 4096;
-    static constexpr std::size_t SCREEN_W   = 64;
-    static constexpr std::size_t SCREEN_H   = 32;
+    static constexpr std::size_t RAM_SIZE   = 0x10000; // XO-CHIP's 64 KiB; CHIP-8 programs use the first 4 KiB
+    static constexpr std::size_t LORES_W    = 64;
+    static constexpr std::size_t LORES_H    = 32;
+    static constexpr std::size_t HIRES_W    = 128; // SUPER-CHIP 00FF
+    static constexpr std::size_t HIRES_H    = 64;
+    static constexpr uint16_t VIP_HIRES_ENTRY = 0x2C0; // see boot_vip_hires()
     static constexpr std::size_t STACK_SIZE = 16;
     static constexpr uint16_t ROM_START     = 0x200;
 
@@ -58,7 +98,7 @@ private:
 
     // Memory & display
     std::array<uint8_t, RAM_SIZE> ram_{};
-    std::array<bool, SCREEN_W * SCREEN_H> display_{};
+    FrameBuffer display_{ LORES_W, LORES_H };
 
     // Stack — managed with an index, not a raw pointer
     std::array<uint16_t, STACK_SIZE> stack_{};
@@ -76,22 +116,140 @@ private:
     // Input
     std::array<bool, 16> keypad_{};
 
-    // Meta
-    std::string rom_name_;
-    Instruction inst_{};
-    bool draw_ = false;
-    Audio &audio_;
+    // SUPER-CHIP RPL user flags (FX75/FX85); like the HP-48's, they survive reset
+    std::array<uint8_t, 16> rpl_{};
+
+    // XO-CHIP: bitplanes DXYN/00E0/scrolls act on (FN01), and the audio
+    // pattern (F002) played at a pitch (FX3A) while the sound timer runs
+    uint8_t planes_         = 1;
+    uint8_t pitch_          = 64; // 4000 Hz playback
+    bool audio_pattern_set_ = false;
+    std::array<uint8_t, 16> audio_pattern_{};
+
+    // The dialect decoded instructions, blocks and JIT code were built for;
+    // run() rebuilds them when the config asks for another one. Nothing is
+    // decoded before the first run(), so a new machine starts with none.
+    static constexpr uint8_t NO_DIALECT = 0xFF;
+    Dialect dialect_{ Extension::CHIP8, NO_DIALECT };
+
+    // Decoded-instruction cache, one slot per byte address of the program
+    // region. With 64 KiB of RAM the program-region tables live on the heap.
+    std::vector<DecodedInst> decode_cache_ = std::vector<DecodedInst>(RAM_SIZE - ROM_START);
+
+    // Basic-block cache (Engine::BLOCK). A block is a run of straight-line
+    // instructions ending in a control-flow op; its ops are stored
+    // contiguously in block_ops_ and executed back to back.
+    struct Block {
+        uint16_t start  = 0; // address of the first instruction
+        uint16_t length = 0; // instruction count, terminator included
+        uint32_t first  = 0; // index of the first op in block_ops_
+        uint64_t runs   = 0; // complete executions not yet added to perf_
+    };
+    static constexpr std::size_t MAX_BLOCK_LEN = 256;
+    std::vector<Block> blocks_;
+    std::vector<DecodedInst> block_ops_;
+    std::vector<int32_t> block_at_    = std::vector<int32_t>(RAM_SIZE - ROM_START, -1); // start address -> index in blocks_, -1 if none
+    std::vector<uint8_t> block_cover_ = std::vector<uint8_t>(RAM_SIZE - ROM_START);     // non-zero if a byte belongs to some block
+    bool blocks_dirty_                = false; // a write hit block code; flush before next lookup
+
+    // Native code for hot blocks (Engine::JIT), created on first use
+    std::unique_ptr<JitCache> jit_;
+
+    // Sprite cache (DXYN). Drawing loops redraw the same few sprites, so the
+    // rows read at I are kept as left-aligned 64-bit masks, direct-mapped by
+    // address. A write to any byte of a cached sprite empties the cache.
+    struct Sprite {
+        uint16_t addr     = 0;
+        uint16_t bytes    = 0; // RAM bytes read, 0 if the slot is empty
+        uint8_t row_bytes = 0; // 2 for 16x16 sprites
+        std::array<uint64_t, 2 * 16> rows{}; // plane after plane (XO-CHIP)
+    };
+    std::array<Sprite, 32> sprites_{};
+    std::vector<uint8_t> sprite_cover_ = std::vector<uint8_t>(RAM_SIZE); // non-zero if a byte belongs to a cached sprite
+    std::size_t sprite_cover_lo_ = RAM_SIZE, sprite_cover_hi_ = 0;       // range of sprite_cover_ that may be set
+
+    // Idle-loop fast-forward (idle.cpp). Heads found not to be idle are
+    // remembered, direct-mapped by address, and left alone for `wait` visits;
+    // the wait doubles with each miss in a row.
+    static constexpr uint32_t MAX_IDLE_LOOP           = 256; // instructions run looking for a cycle
+    static constexpr uint32_t IDLE_STATIC_MISS_WAIT   = 256; // the loop has an op with side effects
+    static constexpr uint32_t IDLE_PROGRESS_MISS_WAIT = 32;  // no cycle within MAX_IDLE_LOOP
+    static constexpr uint32_t MAX_IDLE_STRIKES        = 6;
+    struct IdleMiss {
+        uint16_t head    = 0;
+        uint16_t strikes = 0;
+        uint32_t wait    = 0;
+    };
+    std::array<IdleMiss, 64> idle_misses_{};
+
+    // Instrumentation
+    PerfCounters perf_;
+    std::vector<uint64_t> pc_profile_;
+    Tracer *tracer_     = nullptr;
+    uint32_t trace_seq_ = 0; // instructions traced so far
+
+    // Meta — the ROM stays in memory so reset() never touches the disk
+    std::shared_ptr<const RomImage> rom_;
+    uint64_t rom_hash_ = 0;
+    bool draw_    = false;
+    bool beeping_ = false;
+
+    // Audio synthesis state
+    uint32_t audio_phase_     = 0; // square-wave phase, full cycle = 2^32
+    uint32_t audio_frame_acc_ = 0; // fractional samples per frame, in 1/60 units
 
     // FX0A wait-for-key state
     bool fx0a_waiting_ = false;
     uint8_t fx0a_key_  = 0xFF;
 
     // RNG
-    std::mt19937 rng_{ std::random_device{}() };
+    Mt19937 rng_{ std::random_device{}() };
     std::uniform_int_distribution<int> rand_byte_{ 0, 255 };
 
-    void load_rom(const std::string &rom_path);
+    void load_rom();
     void load_fontset();
+    void boot_vip_hires();
+
+    struct Ops; // opcode handlers, defined in chip8.cpp
+
+    void step(const Config &config);
+    void execute(const Config &config); // step() for the other core files; run() has set the dialect
+    void run_instrumented(const Config &config, uint32_t count); // profiling and/or tracing
+    static DecodedInst decode(uint16_t opcode, const Dialect &dialect);
+    void set_dialect(const Dialect &dialect);
+    uint16_t fetch(uint16_t addr) const;
+    void write_ram(uint16_t addr, uint8_t value);
+    void flush_decode_cache();
+    const uint64_t *sprite_rows(uint16_t addr, unsigned count, unsigned row_bytes);
+    void flush_sprites();
+
+    // Basic-block engine (blocks.cpp)
+    uint32_t run_block(const Config &config, uint32_t budget);
+    Block &build_block(uint16_t start);
+    void flush_blocks();
+    void count_block_runs(); // folds Block::runs into perf_.op_class
+    static bool ends_block(uint16_t opcode);
+
+    // Idle-loop fast-forward (idle.cpp)
+    static bool idle_safe(uint16_t opcode);
+    uint32_t skip_idle(const Config &config, uint32_t budget);
+    void idle_miss(IdleMiss &miss, uint16_t head, uint32_t wait);
+    IdleMiss &idle_miss_slot(uint16_t head) { return idle_misses_[(head >> 1) % idle_misses_.size()]; }
+
+    // Called after a jump back; counting down a miss stays inline in the
+    // engine loops. Returns the instructions executed or skipped.
+    uint32_t try_skip_idle(const Config &config, uint32_t budget) {
+        IdleMiss &miss = idle_miss_slot(PC_);
+        if (miss.head == PC_ && miss.wait > 0) {
+            --miss.wait;
+            return 0;
+        }
+        return skip_idle(config, budget);
+    }
+
+    // x86-64 JIT (jit_x64.cpp)
+    friend class JitCompiler;
+    uint32_t run_jit(const Config &config, uint32_t budget);
 };
 
 #endif
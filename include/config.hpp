@@ -2,14 +2,32 @@
 #define CONFIG_H__
 
 #include <cstdint>
+#include <string>
 
 enum Extension { CHIP8, SUPERCHIP, XOCHIP };
 
+// Behaviours that differ between CHIP-8 implementations, one bit each.
+// Every extension has its own default set; single quirks can be switched
+// on or off over it (per ROM or on the command line).
+enum Quirk : uint8_t {
+  QUIRK_VF_RESET = 1 << 0, // 8XY1/8XY2/8XY3 clear VF
+  QUIRK_SHIFT_VY = 1 << 1, // 8XY6/8XYE shift VY into VX, not VX in place
+  QUIRK_MEMORY_I = 1 << 2, // FX55/FX65 leave I past the last register
+  QUIRK_WRAP     = 1 << 3, // DXYN wraps sprites around the edges instead of clipping
+  QUIRK_JUMP_VX  = 1 << 4, // BXNN jumps to XNN + VX, not NNN + V0
+};
+constexpr uint8_t ALL_QUIRKS = 0x1F;
+
+// CPU execution strategy; all engines produce identical machine state
+enum Engine { INTERPRETER, BLOCK, JIT };
+
 struct Config {
   uint32_t window_width = 64;
   uint32_t window_height = 32;
   uint32_t fg_color = 0xFFFFFFFF; // RGBA8888 white
   uint32_t bg_color = 0x000000FF; // RGBA8888 black
+  uint32_t plane2_color = 0x55FF55FF; // XO-CHIP: lit in the second plane only
+  uint32_t plane3_color = 0xFFAA00FF; // XO-CHIP: lit in both planes
   uint32_t scale_factor = 20;
   bool pixel_outlines = true;
   uint32_t insts_per_second = 700;    // CHIP8 CPU clock rate
@@ -18,8 +36,71 @@ struct Config {
   int16_t volume = 3000;
   float color_lerp_rate = 0.7f; // Amount to lerp colors by
   Extension current_extension = Extension::CHIP8;
+  uint8_t quirks_on = 0;  // Quirk bits forced on over the extension's defaults
+  uint8_t quirks_off = 0; // Quirk bits forced off
+  Engine engine = Engine::INTERPRETER;
+  bool idle_skip = true; // fast-forward loops that only wait for a timer or key
+
+  // Headless run limits (0 = unlimited); the frontend stops at whichever hits first
+  uint64_t max_instructions = 0;
+  uint64_t max_frames = 0;
+
+  // Determinism: CXNN seed (-1 = random) and input movies
+  int64_t seed = -1;
+  std::string record_path; // windowed: record keypad input to this movie
+  std::string replay_path; // headless: replay this movie
+
+  // Profiling: record a hot-PC histogram and write it, with the performance
+  // counters, to this JSON file at exit
+  std::string profile_path;
+
+  // Tracing: write a binary execution trace here from startup
+  std::string trace_path;
+
+  // Frames to run ahead of the input (see RunAhead); 0 = off
+  uint32_t run_ahead = 0;
+
+  // Per-ROM settings database (see RomLibrary)
+  std::string rom_db_path;
+};
+
+// The instruction set a machine runs: an extension with its quirks. The
+// core's decoded and compiled code is specialised for one dialect.
+struct Dialect {
+  Extension extension = Extension::CHIP8;
+  uint8_t quirks = 0; // Quirk bits
+
+  bool operator==(const Dialect &o) const { return extension == o.extension && quirks == o.quirks; }
+  bool operator!=(const Dialect &o) const { return !(*this == o); }
 };
 
+constexpr uint8_t default_quirks(Extension extension) {
+  switch (extension) {
+  case Extension::CHIP8:
+    return QUIRK_VF_RESET | QUIRK_SHIFT_VY | QUIRK_MEMORY_I;
+  case Extension::SUPERCHIP:
+    return QUIRK_JUMP_VX;
+  case Extension::XOCHIP:
+    return QUIRK_SHIFT_VY | QUIRK_MEMORY_I | QUIRK_WRAP;
+  }
+  return 0;
+}
+
+// The extension's quirks with the overrides applied
+inline Dialect dialect(const Config &config) {
+  Dialect d;
+  d.extension = config.current_extension;
+  d.quirks = static_cast<uint8_t>((default_quirks(config.current_extension) | config.quirks_on) &
+                                  ~config.quirks_off & ALL_QUIRKS);
+  return d;
+}
+
+// Quirk overrides as written for --quirks and the ROM database: a comma
+// list of vf_reset, shift_vy, memory_i, wrap and jump_vx, each switched off
+// instead with a leading `-` (`wrap,-vf_reset`). Adds them to `on` and
+// `off`; returns false on an unknown name.
+bool parse_quirks(const std::string &list, uint8_t &on, uint8_t &off);
+
 // Populates config from argv; returns false on parse error
 bool set_config_from_args(Config &config, int argc, char **argv);
 
@@ -0,0 +1,13 @@
+#ifndef DISASM_H__
+#define DISASM_H__
+
+#include "instruction.hpp"
+
+#include <cstdint>
+#include <ostream>
+
+// Writes a human-readable description of one instruction. `return_to` is
+// 00EE's target, printed when known (>= 0).
+void write_mnemonic(std::ostream &out, uint16_t opcode, int return_to = -1);
+
+#endif
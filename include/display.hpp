@@ -1,12 +1,14 @@
 #ifndef DISPLAY_H__
 #define DISPLAY_H__
 
-#include "chip8.hpp"
 #include "config.hpp"
+#include "framebuffer.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_render.h>
 #include <SDL2/SDL_video.h>
+#include <array>
 #include <cstdint>
+#include <vector>
 
 class Display {
 public:
@@ -18,14 +20,21 @@ public:
     Display &operator=(const Display &) = delete;
 
     void clear_screen(const Config &config);
-    void update_screen(const Config &config, const Chip8 &chip8);
+    void update_screen(const Config &config, const FrameBuffer &display); // renders; call present() to show it
+    void present();
 
 private:
     SDL_Window *window_     = nullptr;
     SDL_Renderer *renderer_ = nullptr;
-    std::array<uint32_t, 64 * 32> pixel_color_{};
+    SDL_Texture *texture_   = nullptr; // streaming, one texel per CHIP-8 pixel
 
-    static uint32_t color_lerp(uint32_t start_color, uint32_t end_color, float t);
+    // CPU-side RGBA8888 image uploaded to texture_; rows are `width_` texels
+    std::array<uint32_t, FrameBuffer::MAX_W * FrameBuffer::MAX_H> pixel_color_{};
+    std::size_t width_    = 0;
+    std::size_t height_   = 0;
+    uint64_t fading_rows_ = 0; // rows whose colors have not reached their target yet
+
+    std::vector<SDL_Rect> outline_rects_; // one per lit pixel, drawn in a single call
 };
 
 #endif
@@ -0,0 +1,24 @@
+#ifndef FADE_H__
+#define FADE_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Phosphor-fade kernel: moves RGBA8888 colors toward their targets by a
+// fixed-point weight, per channel:
+//     c' = (c * (256 - w) + t * w + (t > c ? 255 : 0)) >> 8
+// The bias rounds toward the target, so every channel reaches it in a
+// finite number of steps (in one step at w = 255). SSE2/AVX2 and scalar
+// paths produce bit-identical results.
+
+// 8-bit weight for a color_lerp_rate in [0, 1]
+uint8_t fade_weight(float lerp_rate);
+
+// Fades colors[0..n) toward targets[0..n); chunks already at their target
+// are skipped. Returns true if any color still differs from its target.
+bool fade_span(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t weight);
+
+// Portable reference path, used on non-x86 hosts and for comparison
+bool fade_span_scalar(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t weight);
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef FRAMEBUFFER_H__
+#define FRAMEBUFFER_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 1-bit-per-pixel display. Each row is packed into 64-bit words, leftmost
+// pixel in the most significant bit: one word per row at 64x32, two words
+// (a 128-bit row) at the SUPER-CHIP hi-res size. Sprite rows are drawn with
+// a shift, an AND (collision) and an XOR per word instead of per pixel.
+// XO-CHIP adds a second bitplane with the same layout; a pixel's colour is
+// the 2-bit number formed by its bits in both planes. Rows changed since the
+// frontend last looked are tracked in a bitmask.
+class FrameBuffer {
+public:
+    static constexpr std::size_t MAX_W = 128;
+    static constexpr std::size_t MAX_H = 64;
+    static constexpr std::size_t MAX_WORDS = MAX_W / 64; // words per row at MAX_W
+    static constexpr std::size_t PLANES    = 2;
+    static constexpr unsigned ALL_PLANES   = (1u << PLANES) - 1; // plane masks: bit p = plane p
+
+    explicit FrameBuffer(std::size_t width = 64, std::size_t height = 32) { resize(width, height); }
+
+    // Width must be a multiple of 64; contents are cleared
+    void resize(std::size_t width, std::size_t height) {
+        width_  = width;
+        height_ = height;
+        words_  = width / 64;
+        clear();
+    }
+
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t words_per_row() const { return words_; }
+
+    void clear() { clear_planes(ALL_PLANES); }
+
+    void clear_planes(unsigned mask) {
+        for (std::size_t p = 0; p < PLANES; ++p)
+            if ((mask >> p) & 1) planes_[p].fill(0);
+        dirty_ = ~uint64_t{ 0 };
+    }
+
+    // Copies another framebuffer's contents, marking only rows that differ
+    // (or everything, if the size changes) as dirty
+    void assign(const FrameBuffer &other) {
+        if (other.width_ != width_ || other.height_ != height_) {
+            *this  = other;
+            dirty_ = ~uint64_t{ 0 };
+            return;
+        }
+        for (std::size_t p = 0; p < PLANES; ++p) {
+            for (std::size_t y = 0; y < height_; ++y) {
+                for (std::size_t w = 0; w < words_; ++w) {
+                    const std::size_t i = y * words_ + w;
+                    if (planes_[p][i] == other.planes_[p][i]) continue;
+                    planes_[p][i] = other.planes_[p][i];
+                    dirty_ |= uint64_t{ 1 } << y;
+                }
+            }
+        }
+    }
+
+    // Rows touched since the last clear_dirty(), bit y set for row y
+    uint64_t dirty_rows() const { return dirty_; }
+    void clear_dirty() { dirty_ = 0; }
+
+    const uint64_t *row(std::size_t y, unsigned plane = 0) const { return &planes_[plane][y * words_]; }
+
+    bool pixel(std::size_t x, std::size_t y, unsigned plane = 0) const {
+        return (planes_[plane][y * words_ + x / 64] >> (63 - x % 64)) & 1;
+    }
+
+    // XORs a left-aligned sprite row (sprite pixel 0 = bit 63 of `bits`) into
+    // row y of one plane starting at column x. Pixels past the right edge are
+    // clipped. Returns true if any lit pixel was turned off.
+    bool xor_row(std::size_t x, std::size_t y, uint64_t bits, unsigned plane = 0) {
+        uint64_t *words      = &planes_[plane][y * words_];
+        const std::size_t wi = x / 64;
+        const unsigned shift = x % 64;
+
+        const uint64_t lo = bits >> shift;
+        bool hit          = (words[wi] & lo) != 0;
+        words[wi] ^= lo;
+        dirty_ |= uint64_t{ 1 } << y;
+
+        if (shift != 0 && wi + 1 < words_) {
+            const uint64_t hi = bits << (64 - shift);
+            hit |= (words[wi + 1] & hi) != 0;
+            words[wi + 1] ^= hi;
+        }
+        return hit;
+    }
+
+    // xor_row() for `count` (1-64) sprite rows drawn on rows y, y + 1, ...,
+    // all of which must be on screen. The word split is worked out once for
+    // the whole sprite. `skip` drops that many leading sprite columns, for
+    // the part of a sprite that wraps around to x = 0.
+    bool xor_rows(std::size_t x, std::size_t y, const uint64_t *bits, std::size_t count, unsigned plane = 0,
+                  unsigned skip = 0) {
+        if (count == 0) return false;
+        uint64_t *words      = &planes_[plane][y * words_ + x / 64];
+        const unsigned shift = x % 64;
+
+        uint64_t hit = 0;
+        if (shift != 0 && x / 64 + 1 < words_) {
+            for (std::size_t r = 0; r < count; ++r, words += words_) {
+                const uint64_t lo = (bits[r] << skip) >> shift;
+                const uint64_t hi = (bits[r] << skip) << (64 - shift);
+                hit |= (words[0] & lo) | (words[1] & hi);
+                words[0] ^= lo;
+                words[1] ^= hi;
+            }
+        } else {
+            for (std::size_t r = 0; r < count; ++r, words += words_) {
+                const uint64_t lo = (bits[r] << skip) >> shift;
+                hit |= words[0] & lo;
+                words[0] ^= lo;
+            }
+        }
+        dirty_ |= (~uint64_t{ 0 } >> (64 - count)) << y;
+        return hit != 0;
+    }
+
+    // SUPER-CHIP / XO-CHIP scrolling of the planes in `mask`. Rows move as
+    // whole packed words: vertical scrolls are one memmove per plane,
+    // sideways ones a shift per word.
+    void scroll_down(std::size_t n, unsigned mask = ALL_PLANES) {
+        n = n < height_ ? n : height_;
+        for (std::size_t p = 0; p < PLANES; ++p) {
+            if (!((mask >> p) & 1)) continue;
+            uint64_t *rows = planes_[p].data();
+            std::memmove(rows + n * words_, rows, (height_ - n) * words_ * sizeof(uint64_t));
+            std::memset(rows, 0, n * words_ * sizeof(uint64_t));
+        }
+        dirty_ = ~uint64_t{ 0 };
+    }
+
+    void scroll_up(std::size_t n, unsigned mask = ALL_PLANES) {
+        n = n < height_ ? n : height_;
+        for (std::size_t p = 0; p < PLANES; ++p) {
+            if (!((mask >> p) & 1)) continue;
+            uint64_t *rows = planes_[p].data();
+            std::memmove(rows, rows + n * words_, (height_ - n) * words_ * sizeof(uint64_t));
+            std::memset(rows + (height_ - n) * words_, 0, n * words_ * sizeof(uint64_t));
+        }
+        dirty_ = ~uint64_t{ 0 };
+    }
+
+    // Shifts every row `n` (1-63) pixels left; pixels pushed off are lost
+    void scroll_left(unsigned n, unsigned mask = ALL_PLANES) {
+        for (std::size_t p = 0; p < PLANES; ++p) {
+            if (!((mask >> p) & 1)) continue;
+            for (std::size_t y = 0; y < height_; ++y) {
+                uint64_t *words = &planes_[p][y * words_];
+                for (std::size_t w = 0; w < words_; ++w) {
+                    const uint64_t carry = w + 1 < words_ ? words[w + 1] >> (64 - n) : 0;
+                    words[w]             = (words[w] << n) | carry;
+                }
+            }
+        }
+        dirty_ = ~uint64_t{ 0 };
+    }
+
+    // Shifts every row `n` (1-63) pixels right
+    void scroll_right(unsigned n, unsigned mask = ALL_PLANES) {
+        for (std::size_t p = 0; p < PLANES; ++p) {
+            if (!((mask >> p) & 1)) continue;
+            for (std::size_t y = 0; y < height_; ++y) {
+                uint64_t *words = &planes_[p][y * words_];
+                for (std::size_t w = words_; w-- > 0;) {
+                    const uint64_t carry = w > 0 ? words[w - 1] << (64 - n) : 0;
+                    words[w]             = (words[w] >> n) | carry;
+                }
+            }
+        }
+        dirty_ = ~uint64_t{ 0 };
+    }
+
+    // FNV-1a over the packed rows, for golden comparisons. The second plane
+    // is only folded in once something is lit there, so single-plane screens
+    // hash the same as before XO-CHIP support.
+    uint64_t hash() const {
+        const std::size_t n = height_ * words_;
+        uint64_t h          = 0xCBF29CE484222325ULL;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= planes_[0][i];
+            h *= 0x100000001B3ULL;
+        }
+
+        uint64_t used = 0;
+        for (std::size_t i = 0; i < n; ++i) used |= planes_[1][i];
+        if (used == 0) return h;
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= planes_[1][i];
+            h *= 0x100000001B3ULL;
+        }
+        return h;
+    }
+
+    // Expands row y to one bool per pixel, set if lit in any plane (out must
+    // hold width() entries)
+    void unpack_row(std::size_t y, bool *out) const {
+        const uint64_t *p0 = row(y, 0);
+        const uint64_t *p1 = row(y, 1);
+        for (std::size_t x = 0; x < width_; ++x)
+            out[x] = ((p0[x / 64] | p1[x / 64]) >> (63 - x % 64)) & 1;
+    }
+
+    // Expands row y to one colour index (0-3, bit p = plane p) per pixel
+    void unpack_colors(std::size_t y, uint8_t *out) const {
+        const uint64_t *p0 = row(y, 0);
+        const uint64_t *p1 = row(y, 1);
+        for (std::size_t x = 0; x < width_; ++x) {
+            const unsigned bit = 63 - x % 64;
+            out[x] = static_cast<uint8_t>(((p0[x / 64] >> bit) & 1) | (((p1[x / 64] >> bit) & 1) << 1));
+        }
+    }
+
+private:
+    std::size_t width_  = 0;
+    std::size_t height_ = 0;
+    std::size_t words_  = 0;
+    uint64_t dirty_     = 0;
+    std::array<std::array<uint64_t, MAX_WORDS * MAX_H>, PLANES> planes_{};
+};
+
+#endif
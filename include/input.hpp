@@ -0,0 +1,42 @@
+#ifndef INPUT_H__
+#define INPUT_H__
+
+#include "chip8.hpp"
+#include "config.hpp"
+#include "ring_buffer.hpp"
+
+#include <cstdint>
+
+// Frontend-level requests raised by hotkeys, acted on by the emulation loop
+struct InputActions {
+    bool reset        = false; // =, one-shot
+    bool save_state   = false; // F5, one-shot
+    bool load_state   = false; // F9, one-shot
+    bool rewinding    = false; // held while Backspace is down
+    bool dump_perf    = false; // F2, one-shot
+    bool toggle_trace = false; // F3, one-shot
+};
+
+// One keypad or hotkey event, passed from the event thread to the
+// emulation thread
+struct InputMessage {
+    enum Type : uint8_t { KEY, PAUSE, QUIT, RESET, SAVE_STATE, LOAD_STATE, REWIND, DUMP_PERF, TOGGLE_TRACE, VOLUME };
+
+    Type type     = KEY;
+    uint8_t key   = 0;     // KEY: keypad key 0-F
+    bool down     = false; // KEY, REWIND: pressed or released
+    int16_t value = 0;     // VOLUME: the new volume
+};
+
+// Events are dropped if the emulation thread falls this far behind
+using InputQueue = SpscRing<InputMessage, 256>;
+
+// Event thread: drains the SDL event queue into `queue`. Display settings
+// (colour fade) are changed in `config` directly.
+void handle_input(InputQueue &queue, Config &config);
+
+// Emulation thread: applies one event to the core, its config and the
+// pending hotkey actions
+void apply_input(const InputMessage &event, Chip8 &chip8, Config &config, InputActions &actions);
+
+#endif
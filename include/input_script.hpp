@@ -0,0 +1,38 @@
+#ifndef INPUT_SCRIPT_H__
+#define INPUT_SCRIPT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Chip8;
+
+// A keypad press or release, applied before the given frame executes
+struct InputEvent {
+    uint64_t frame = 0;
+    uint8_t key    = 0;
+    bool pressed   = false;
+};
+
+// Scripted keypad input for unattended runs. Text format, one event per
+// line: `<frame> <key 0-F> <down|up>`; blank lines and `#` comments are
+// ignored. A script is immutable once loaded, so one instance can drive any
+// number of machines at once — each run keeps its own cursor.
+class InputScript {
+public:
+    // Prints the offending line to stderr and returns false on error
+    bool load(const std::string &path);
+
+    void add(const InputEvent &event);
+    const std::vector<InputEvent> &events() const { return events_; }
+    bool empty() const { return events_.empty(); }
+
+    // Applies every event scheduled for `frame`, advancing `cursor`
+    void apply(Chip8 &chip8, uint64_t frame, std::size_t &cursor) const;
+
+private:
+    std::vector<InputEvent> events_; // sorted by frame, file order within a frame
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef INSTRUCTION_H__
+#define INSTRUCTION_H__
+
+#include "config.hpp"
+
+#include <cstdint>
+
+struct Instruction {
+    uint16_t opcode = 0;
+    uint16_t NNN    = 0; // 12-bit address / constant
+    uint8_t NN      = 0; // 8-bit constant
+    uint8_t N       = 0; // 4-bit constant
+    uint8_t X       = 0; // 4-bit register index
+    uint8_t Y       = 0; // 4-bit register index
+};
+
+class Chip8;
+struct DecodedInst;
+using OpHandler = void (*)(Chip8 &, const DecodedInst &, const Config &);
+
+// An instruction with its handler resolved ahead of time
+struct DecodedInst : Instruction {
+    OpHandler fn = nullptr; // nullptr marks an empty decode-cache slot
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef JIT_H__
+#define JIT_H__
+
+#include "config.hpp"
+#include "instruction.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class Chip8;
+
+// Executable memory and lookup table for natively compiled CHIP-8 blocks.
+// Only functional on x86-64 POSIX hosts; elsewhere available() is false and
+// the core falls back to the basic-block engine.
+class JitCache {
+public:
+    // A compiled block; returns the number of CHIP-8 instructions it executed
+    using BlockFn = uint32_t (*)(Chip8 *chip8, const Config *config);
+
+    static constexpr std::size_t CODE_SIZE   = 1 << 20; // 1 MiB of code
+    static constexpr std::size_t REGION_SIZE = 0x10000 - 0x200;
+    static constexpr uint16_t HOT_THRESHOLD  = 8; // block-engine runs before compiling
+
+    struct Entry {
+        BlockFn fn      = nullptr;
+        uint16_t length = 0; // instruction count of the compiled block
+        uint16_t heat   = 0; // executions seen while not yet compiled
+    };
+
+    JitCache();
+    ~JitCache();
+
+    // Non-copyable
+    JitCache(const JitCache &)            = delete;
+    JitCache &operator=(const JitCache &) = delete;
+
+    bool available() const { return code_ != nullptr; }
+
+    // Drops every compiled block, e.g. when the machine's dialect changes
+    void clear();
+
+    Entry &entry(std::size_t offset) { return entries_[offset]; }
+
+    // Copies machine code into the executable region; nullptr when full
+    BlockFn install(const std::vector<uint8_t> &code);
+
+    // Stable storage for operands that compiled code passes to handlers
+    const DecodedInst *keep(const DecodedInst &inst);
+
+    // Per-exit run counter. Compiled code bumps `runs` once per exit taken;
+    // the opcode classes retired by that exit are fixed at compile time.
+    struct ExitCounter {
+        uint64_t runs = 0;
+        std::array<uint16_t, 16> retired{};
+    };
+    ExitCounter *add_exit(const std::array<uint16_t, 16> &retired);
+
+    // Adds the instructions retired since the last call to `op_class`
+    void drain_counts(std::array<uint64_t, 16> &op_class);
+
+private:
+    uint8_t *code_         = nullptr;
+    std::size_t code_used_ = 0;
+    std::array<Entry, REGION_SIZE> entries_{};
+    std::deque<DecodedInst> ops_;
+    std::deque<ExitCounter> exits_;
+    std::array<uint64_t, 16> drained_{}; // counts of exits dropped by clear()
+};
+
+#endif
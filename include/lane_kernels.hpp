@@ -0,0 +1,115 @@
+#ifndef LANE_KERNELS_H__
+#define LANE_KERNELS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Data-parallel building blocks for the lockstep engine. Every kernel works
+// on `n` lanes of structure-of-arrays state and only touches lanes whose
+// `mask` byte is 0xFF. Loads and stores happen in the same order as in the
+// scalar Chip8 handlers, so aliased operands (X == F, Y == F, X == Y) give
+// identical results.
+enum class LaneAlu : uint8_t {
+    SET_NN, // 6XNN
+    ADD_NN, // 7XNN
+    MOV,    // 8XY0
+    OR,     // 8XY1
+    AND,    // 8XY2
+    XOR,    // 8XY3
+    ADD,    // 8XY4
+    SUB,    // 8XY5
+    SHR,    // 8XY6
+    SUBN,   // 8XY7
+    SHL,    // 8XYE
+};
+
+enum class LaneSkip : uint8_t {
+    EQ_NN, // 3XNN
+    NE_NN, // 4XNN
+    EQ,    // 5XY0
+    NE,    // 9XY0
+};
+
+// One lane of LaneKernels::alu, for code that executes lanes individually
+inline void lane_alu(LaneAlu op, uint8_t &vx, const uint8_t &vy, uint8_t &vf, uint8_t nn, bool quirks) {
+    switch (op) {
+        case LaneAlu::SET_NN: vx = nn; break;
+        case LaneAlu::ADD_NN: vx = static_cast<uint8_t>(vx + nn); break;
+        case LaneAlu::MOV: vx = vy; break;
+        case LaneAlu::OR:
+            vx |= vy;
+            if (quirks) vf = 0;
+            break;
+        case LaneAlu::AND:
+            vx &= vy;
+            if (quirks) vf = 0;
+            break;
+        case LaneAlu::XOR:
+            vx ^= vy;
+            if (quirks) vf = 0;
+            break;
+        case LaneAlu::ADD: {
+            const uint16_t sum = static_cast<uint16_t>(vx) + vy;
+            vx                 = static_cast<uint8_t>(sum);
+            vf                 = sum > 0xFF ? 1 : 0;
+            break;
+        }
+        case LaneAlu::SUB: {
+            const uint8_t a = vx, b = vy;
+            vx              = static_cast<uint8_t>(a - b);
+            vf              = a >= b ? 1 : 0;
+            break;
+        }
+        case LaneAlu::SUBN: {
+            const uint8_t a = vx, b = vy;
+            vx              = static_cast<uint8_t>(b - a);
+            vf              = b >= a ? 1 : 0;
+            break;
+        }
+        case LaneAlu::SHR: {
+            const uint8_t &src = quirks ? vy : vx;
+            vf                 = src & 0x01;
+            vx                 = src >> 1;
+            break;
+        }
+        case LaneAlu::SHL: {
+            const uint8_t &src = quirks ? vy : vx;
+            vf                 = (src & 0x80) >> 7;
+            vx                 = static_cast<uint8_t>(src << 1);
+            break;
+        }
+    }
+}
+
+struct LaneKernels {
+    // Moves the pending lanes whose pc equals `value` into a group:
+    // group[l] = 0xFF and pending[l] = 0 for them, group[l] = 0 elsewhere.
+    // Returns the group size.
+    std::size_t (*match)(const uint16_t *pc, uint16_t value, uint8_t *pending, uint8_t *group, std::size_t n);
+
+    // VX op= VY / NN; `quirks` selects the original CHIP-8 behaviour (VF reset
+    // on logic ops, shifts read VY)
+    void (*alu)(LaneAlu op, uint8_t *vx, const uint8_t *vy, uint8_t *vf, uint8_t nn, bool quirks,
+                const uint8_t *mask, std::size_t n);
+
+    // pc += 2 where the comparison holds
+    void (*skip)(LaneSkip op, const uint8_t *vx, const uint8_t *vy, uint8_t nn, uint16_t *pc,
+                 const uint8_t *mask, std::size_t n);
+
+    void (*set16)(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n); // dst = value
+    void (*add16)(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n); // dst += value
+    void (*add16_u8)(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n); // FX1E
+    void (*digit16)(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n);  // FX29: dst = src * 5
+    void (*copy8)(uint8_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n);
+
+    // One 60 Hz tick on every lane: beeping = sound > 0, both timers count down to 0
+    void (*timers)(uint8_t *delay, uint8_t *sound, uint8_t *beeping, std::size_t n);
+
+    const char *name;
+};
+
+// AVX2 kernels when the host supports them, portable ones otherwise
+const LaneKernels &lane_kernels();
+const LaneKernels &lane_kernels_scalar();
+
+#endif
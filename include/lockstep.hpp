@@ -0,0 +1,109 @@
+#ifndef LOCKSTEP_H__
+#define LOCKSTEP_H__
+
+#include "config.hpp"
+#include "framebuffer.hpp"
+#include "instruction.hpp"
+#include "lane_kernels.hpp"
+#include "rng.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Runs N copies ("lanes") of one ROM side by side, for fuzzing and search
+// workloads that want many seeds or input streams of the same program.
+// Per-machine state is stored structure-of-arrays — register VX of lane l
+// lives at V_[X * lanes + l] — so an instruction can be applied to all lanes
+// with the data-parallel lane kernels. Each step, lanes sharing a PC execute
+// the instruction as one group: the first lane not yet stepped picks the PC,
+// every other lane at that PC joins it, and so on until groups get too small
+// to pay for the pass. Whatever is left (badly diverged lanes) is stepped one
+// lane at a time; lanes regroup as soon as their PCs coincide again.
+// Observable behaviour of every lane is the same as a Chip8 running alone.
+// Only CHIP-8 and SUPER-CHIP with their default quirks are supported:
+// lanes keep a 4 KiB address space, which XO-CHIP programs outgrow.
+class Lockstep {
+public:
+    Lockstep(const std::string &rom_path, std::size_t lanes);
+
+    bool loaded() const { return loaded_; }
+    std::size_t lanes() const { return lanes_; }
+
+    // Per-lane inputs
+    void seed_rng(std::size_t lane, uint32_t seed);
+    void set_key(std::size_t lane, uint8_t key, bool pressed);
+
+    void run(const Config &config, uint32_t count); // `count` instructions on every lane
+    void update_timers();
+
+    const FrameBuffer &get_display(std::size_t lane) const { return display_[lane]; }
+    uint64_t display_hash(std::size_t lane) const { return display_[lane].hash(); }
+    bool is_beeping(std::size_t lane) const { return beeping_[lane] != 0; }
+
+    // Lane-instructions executed as part of the group vs. individually
+    uint64_t grouped_steps() const { return grouped_steps_; }
+    uint64_t single_steps() const { return single_steps_; }
+    const char *kernels_name() const { return kernels_.name; }
+
+private:
+    static constexpr std::size_t RAM_SIZE   = 4096;
+    static constexpr std::size_t LORES_W    = 64;
+    static constexpr std::size_t LORES_H    = 32;
+    static constexpr std::size_t HIRES_W    = 128;
+    static constexpr std::size_t HIRES_H    = 64;
+    static constexpr uint16_t VIP_HIRES_ENTRY = 0x2C0;
+    static constexpr std::size_t STACK_SIZE = 16;
+    static constexpr uint16_t ROM_START     = 0x200;
+    static constexpr int MAX_GROUP_MISSES   = 2; // groups smaller than MIN_GROUP before giving up
+    static constexpr std::size_t MIN_GROUP  = 4;
+
+    std::size_t lanes_ = 0;
+    bool loaded_       = false;
+    const LaneKernels &kernels_;
+
+    // SoA machine state, one slot per lane
+    std::vector<uint8_t> V_;      // 16 register rows of `lanes_` bytes
+    std::vector<uint16_t> I_;
+    std::vector<uint16_t> PC_;
+    std::vector<uint16_t> stack_; // STACK_SIZE rows of `lanes_` return addresses
+    std::vector<uint8_t> sp_;
+    std::vector<uint8_t> delay_timer_;
+    std::vector<uint8_t> sound_timer_;
+    std::vector<uint8_t> beeping_;
+    std::vector<uint16_t> keypad_;  // bit k set while key k is held
+    std::vector<uint8_t> fx0a_key_; // key FX0A is waiting on to be released, 0xFF if none
+    std::vector<std::array<uint8_t, 16>> rpl_; // SUPER-CHIP user flags
+
+    // Per-lane memory, display and RNG (indexed by address, not by lane)
+    std::vector<std::array<uint8_t, RAM_SIZE>> ram_;
+    std::vector<FrameBuffer> display_;
+    std::vector<Mt19937> rng_;
+
+    // Bytes any lane has stored to. Lanes start with identical RAM, so code
+    // at an unwritten address is the same for every lane and is fetched once
+    // per group; at a written one each member's opcode is checked.
+    std::array<uint8_t, RAM_SIZE> written_{};
+
+    std::vector<uint8_t> pending_; // 0xFF for lanes not yet stepped this step
+    std::vector<uint8_t> group_;   // 0xFF for lanes in the group being executed
+
+    uint64_t grouped_steps_ = 0;
+    uint64_t single_steps_  = 0;
+
+    uint8_t *V(uint8_t x) { return &V_[x * lanes_]; }
+    uint8_t &V(uint8_t x, std::size_t lane) { return V_[x * lanes_ + lane]; }
+
+    bool load_rom(const std::string &rom_path);
+    void step(const Config &config);
+    bool step_group(const Config &config, const Instruction &inst);
+    void step_lane(const Config &config, std::size_t lane);
+    void execute(const Config &config, std::size_t lane, const Instruction &inst);
+    void write_ram(std::size_t lane, uint16_t addr, uint8_t value);
+    uint16_t fetch(std::size_t lane, uint16_t addr) const;
+    static Instruction split(uint16_t opcode);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef MOVIE_H__
+#define MOVIE_H__
+
+#include "config.hpp"
+#include "input_script.hpp"
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Fixed header of a movie file. Together with the ROM, it pins down
+// everything a run depends on: the RNG seed, the instructions per frame,
+// the quirk set and the keypad input. Replaying it must end on final_hash.
+struct MovieHeader {
+    static constexpr uint32_t MAGIC   = 0x564D3843; // "C8MV" in little-endian
+    static constexpr uint16_t VERSION = 2;
+
+    uint32_t magic            = MAGIC;
+    uint16_t version          = VERSION;
+    uint8_t extension         = 0;
+    uint8_t quirks            = 0; // Quirk bits in effect; version 1 had the extension's defaults
+    uint32_t seed             = 0;
+    uint32_t insts_per_second = 0;
+    uint64_t rom_hash         = 0;
+    uint64_t frames           = 0; // frames the recording ran for
+    uint64_t final_hash       = 0; // display hash after the last frame
+    uint64_t event_count      = 0;
+};
+
+// One keypad change as stored on disk, applied before `frame` executes
+struct MovieEvent {
+    uint32_t frame   = 0;
+    uint8_t key      = 0;
+    uint8_t pressed  = 0;
+    uint16_t padding = 0;
+};
+
+static_assert(std::is_trivially_copyable<MovieHeader>::value && sizeof(MovieHeader) == 48, "raw on-disk layout");
+static_assert(std::is_trivially_copyable<MovieEvent>::value && sizeof(MovieEvent) == 8, "raw on-disk layout");
+
+// Input movie: a deterministic run recorded as the keypad changes per
+// frame. Recording only logs keys whose state differs from the previous
+// frame, so an idle minute of play costs nothing.
+class Movie {
+public:
+    // Recording
+    void start(uint64_t rom_hash, uint32_t seed, const Config &config);
+    void record_frame(uint64_t frame, uint16_t keypad); // keypad as seen before `frame` runs
+    void finish(uint64_t frames, uint64_t final_hash);
+
+    // Both print the reason to stderr on failure
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+
+    const MovieHeader &header() const { return header_; }
+    const InputScript &input() const { return input_; }
+
+    // Copies the recorded timing and quirk settings into a config for replay
+    void apply_settings(Config &config) const;
+
+private:
+    MovieHeader header_;
+    InputScript input_;
+    uint16_t keypad_ = 0; // state after the last recorded frame
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PERF_H__
+#define PERF_H__
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Host-side stages of one frontend frame
+enum class Stage { EXECUTE, RUN_AHEAD, RENDER, PRESENT, SLEEP, COUNT };
+
+// Always-on performance counters. The core fills in the instruction and
+// sprite counters as it runs (one add per instruction in the interpreter and
+// block engine, a few adds per block exit in JIT code); frontends fill in the
+// frame, audio and per-stage host time counters.
+struct PerfCounters {
+    std::array<uint64_t, 16> op_class{}; // instructions executed, by top opcode nibble
+    uint64_t draws       = 0;            // DXYN executed
+    uint64_t sprite_rows = 0;            // sprite rows blitted (after clipping)
+    uint64_t collisions  = 0;            // DXYN that set VF
+    uint64_t idle_instructions = 0;      // skipped in idle loops, not in op_class
+    uint64_t frames      = 0;            // frames presented
+    uint64_t audio_underruns = 0;
+    std::array<uint64_t, static_cast<std::size_t>(Stage::COUNT)> stage_ns{};
+
+    uint64_t instructions() const;
+    void clear() { *this = PerfCounters{}; }
+};
+
+// Adds the host time spent in its scope to one stage
+class StageTimer {
+public:
+    StageTimer(PerfCounters &perf, Stage stage)
+        : slot_(perf.stage_ns[static_cast<std::size_t>(stage)]), start_(std::chrono::steady_clock::now()) {}
+    ~StageTimer() {
+        slot_ += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+    // Non-copyable
+    StageTimer(const StageTimer &)            = delete;
+    StageTimer &operator=(const StageTimer &) = delete;
+
+private:
+    uint64_t &slot_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Writes the counters as a JSON object. A non-empty `pc_profile` (executions
+// per RAM address) is added as a hot-PC histogram, hottest address first.
+void write_perf_json(std::ostream &out, const PerfCounters &perf, const std::vector<uint64_t> &pc_profile);
+
+// Same, to a file; prints the reason to stderr on failure
+bool save_perf_json(const std::string &path, const PerfCounters &perf, const std::vector<uint64_t> &pc_profile);
+
+#endif
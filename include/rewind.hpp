@@ -0,0 +1,49 @@
+#ifndef REWIND_H__
+#define REWIND_H__
+
+#include "savestate.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Bounded history of save states for rewinding, one per frame. Only the
+// newest state is kept whole; every older one is stored as a backward delta
+// (the 64-bit words that differ from the state after it), so stepping back
+// applies one delta. Deltas live in a fixed byte ring: when it fills up, the
+// oldest history is dropped. A frame that changes a few registers, a few
+// display rows and a handful of RAM bytes costs well under a hundred bytes.
+class RewindBuffer {
+public:
+    explicit RewindBuffer(std::size_t capacity_bytes = 256 * 1024);
+
+    // Records the state after a frame
+    void push(const SaveState &state);
+
+    // Drops the newest state and writes the one before it to `state`;
+    // false (and `state` untouched) when there is no earlier state
+    bool step_back(SaveState &state);
+
+    void clear();
+
+    std::size_t frames() const { return has_newest_ ? entries_.size() + 1 : 0; } // states held
+    std::size_t bytes_used() const;                                               // delta bytes held
+    std::size_t capacity() const { return arena_.size(); }
+
+private:
+    struct Entry {
+        std::size_t offset = 0; // into arena_
+        std::size_t size   = 0;
+    };
+
+    std::vector<uint8_t> arena_;
+    std::size_t head_ = 0;     // next write offset
+    std::deque<Entry> entries_; // oldest first; entry i restores state i from state i + 1
+
+    SaveState newest_;
+    bool has_newest_ = false;
+    std::vector<uint8_t> scratch_; // delta being encoded
+};
+
+#endif
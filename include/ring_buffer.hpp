@@ -0,0 +1,65 @@
+#ifndef RING_BUFFER_H__
+#define RING_BUFFER_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Lock-free single-producer / single-consumer ring of trivially copyable
+// items. One thread may only push, the other may only pop; neither blocks.
+// Capacity must be a power of two.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "items are copied with memcpy");
+
+public:
+    // Producer: copies up to n items in; returns how many fit
+    std::size_t push(const T *items, std::size_t n) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        if (n > Capacity - (head - tail)) n = Capacity - (head - tail);
+
+        const std::size_t at    = head & (Capacity - 1);
+        const std::size_t first = n < Capacity - at ? n : Capacity - at;
+        std::memcpy(&buf_[at], items, first * sizeof(T));
+        std::memcpy(&buf_[0], items + first, (n - first) * sizeof(T));
+
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    bool push(const T &item) { return push(&item, 1) == 1; }
+
+    // Consumer: copies up to n items out; returns how many were available
+    std::size_t pop(T *items, std::size_t n) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        if (n > head - tail) n = head - tail;
+
+        const std::size_t at    = tail & (Capacity - 1);
+        const std::size_t first = n < Capacity - at ? n : Capacity - at;
+        std::memcpy(items, &buf_[at], first * sizeof(T));
+        std::memcpy(items + first, &buf_[0], (n - first) * sizeof(T));
+
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    bool pop(T &item) { return pop(&item, 1) == 1; }
+
+    // Approximate when called from the other side
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    T buf_[Capacity];
+    alignas(64) std::atomic<std::size_t> head_{ 0 }; // written by the producer
+    alignas(64) std::atomic<std::size_t> tail_{ 0 }; // written by the consumer
+};
+
+#endif
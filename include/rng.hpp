@@ -0,0 +1,13 @@
+#ifndef RNG_H__
+#define RNG_H__
+
+#include <cstdint>
+#include <random>
+
+// std::mt19937 with 32-bit state words. It produces exactly the same
+// sequence, but std::mt19937 is declared over uint_fast32_t, which is 64 bits
+// on LP64 hosts and doubles the state that every snapshot has to copy.
+using Mt19937 = std::mersenne_twister_engine<uint32_t, 32, 624, 397, 31, 0x9908B0DFu, 11, 0xFFFFFFFFu, 7,
+                                             0x9D2C5680u, 15, 0xEFC60000u, 18, 1812433253u>;
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef ROM_LIBRARY_H__
+#define ROM_LIBRARY_H__
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The bytes of one ROM file, read once and then shared by every machine
+// running it: a reset copies from here instead of going back to disk.
+// Files are memory-mapped on POSIX hosts and read into a buffer elsewhere.
+// Images never change after opening, so any number of threads may use one.
+class RomImage {
+public:
+    // Prints the reason to stderr and returns nullptr if the file cannot be read
+    static std::shared_ptr<const RomImage> open(const std::string &path);
+
+    ~RomImage();
+
+    // Non-copyable
+    RomImage(const RomImage &)            = delete;
+    RomImage &operator=(const RomImage &) = delete;
+
+    const std::string &path() const { return path_; }
+    const uint8_t *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    uint64_t hash() const { return hash_; } // FNV-1a of the contents; Chip8::rom_hash()
+
+private:
+    RomImage() = default;
+
+    std::string path_;
+    const uint8_t *data_ = nullptr;
+    std::size_t size_    = 0;
+    uint64_t hash_       = 0;
+    void *mapping_       = nullptr; // unmapped on destruction, if set
+    std::vector<uint8_t> buffer_;   // holds the bytes when not mapped
+};
+
+// Per-ROM settings. Fields left unset keep whatever the caller had.
+struct RomSettings {
+    std::string title;
+    int extension             = -1; // an Extension, or -1 if unset
+    uint8_t quirks_on         = 0;  // Quirk overrides on top of the extension's
+    uint8_t quirks_off        = 0;
+    uint32_t insts_per_second = 0;  // 0 if unset
+    std::string keys;               // key hints for the player
+
+    // Defaults for this ROM; apply before set_config_from_args so the
+    // command line still wins
+    void apply(Config &config) const;
+};
+
+// A set of ROM images keyed by path, and a database of settings keyed by
+// content hash, so a ROM keeps its settings wherever the file lives and
+// whatever it is called.
+//
+// The database is a small TOML subset, one table per ROM:
+//
+//     # comment
+//     [8b3c1ad8e2f0b9c4]          # RomImage::hash(), 16 hex digits
+//     title = "Space Invaders"
+//     extension = 1               # 0 CHIP-8, 1 SUPER-CHIP, 2 XO-CHIP
+//     quirks = "-jump_vx"         # as for --quirks
+//     insts_per_second = 700
+//     keys = "5 fire, 4/6 move"
+//
+// ROMs without key hints in the database fall back to the text of a `.txt`
+// file next to the ROM, as shipped in roms/.
+class RomLibrary {
+public:
+    // Prints the offending line to stderr and returns false on error
+    bool load_database(const std::string &path);
+
+    // The image for `path`, opened on first use; thread-safe
+    std::shared_ptr<const RomImage> open(const std::string &path);
+
+    // Database entry for `rom`, with the sidecar text as key hints if needed
+    RomSettings settings(const RomImage &rom) const;
+
+    // Config for running `rom`: defaults, then its settings, then the
+    // command line on top. Returns false on a command-line parse error.
+    bool configure(Config &config, const RomImage &rom, int argc, char **argv) const;
+
+    std::size_t database_size() const { return database_.size(); }
+
+private:
+    std::unordered_map<uint64_t, RomSettings> database_;
+
+    std::mutex mutex_; // guards images_
+    std::unordered_map<std::string, std::shared_ptr<const RomImage>> images_;
+};
+
+#endif
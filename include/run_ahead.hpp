@@ -0,0 +1,48 @@
+#ifndef RUN_AHEAD_H__
+#define RUN_AHEAD_H__
+
+#include "chip8.hpp"
+#include "config.hpp"
+#include "perf.hpp"
+#include "savestate.hpp"
+#include "scheduler.hpp"
+
+#include <cstdint>
+
+// Run-ahead hides input latency. After each real frame the machine is
+// emulated `frames` frames further with the keys held now, the frontend
+// shows that speculative screen, and the machine is put back. A key press
+// therefore shows up `frames` frames sooner, while the real timeline is
+// unchanged and stays deterministic.
+//
+// Snapshots are ordinary SaveStates. The caller passes the one it already
+// takes for rewind, and restoring only touches RAM that changed. The
+// speculative frames do not count as work in the performance counters;
+// their host time goes to Stage::RUN_AHEAD. Profiles and traces would
+// record the speculative instructions, so frontends skip run-ahead while
+// either is active.
+class RunAhead {
+public:
+    explicit RunAhead(uint32_t frames = 0) : frames_(frames) {}
+
+    uint32_t frames() const { return frames_; }
+    bool enabled() const { return frames_ > 0; }
+
+    // Moves `chip8` frames() frames ahead; save its state first, for
+    // restore(). The scheduler is copied, so the real frame cadence is
+    // untouched.
+    void speculate(Chip8 &chip8, const Config &config, const Scheduler &scheduler);
+
+    // Puts the machine back to `now`, its state before speculate(), once
+    // the speculative frame has been shown
+    void restore(Chip8 &chip8, const SaveState &now);
+
+    uint64_t last_ns() const { return last_ns_; } // host time of the last speculate + restore
+
+private:
+    uint32_t frames_  = 0;
+    uint64_t last_ns_ = 0;
+    PerfCounters saved_; // counters as they were before speculating
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SAVESTATE_H__
+#define SAVESTATE_H__
+
+#include "framebuffer.hpp"
+#include "rng.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Complete machine state of a Chip8, laid out as one flat, trivially copyable
+// block. The struct is the on-disk format: files are the raw bytes, so
+// saving and loading are a single write/read with no field-by-field
+// serialization. Files are tied to the host's byte order and the layout of
+// this build; the header rejects anything else.
+struct SaveState {
+    static constexpr uint32_t MAGIC   = 0x53533843; // "C8SS" in little-endian
+    static constexpr uint16_t VERSION = 3;
+
+    // Header
+    uint32_t magic    = MAGIC;
+    uint16_t version  = VERSION;
+    uint16_t reserved = 0;
+    uint32_t size     = 0; // sizeof(SaveState) of the writer
+    uint32_t padding  = 0;
+
+    // Memory, display and RNG
+    std::array<uint8_t, 0x10000> ram{}; // 64 KiB, for XO-CHIP
+    FrameBuffer display;
+    Mt19937 rng;
+
+    // CPU
+    std::array<uint16_t, 16> stack{};
+    std::array<uint8_t, 16> V{};
+    std::array<bool, 16> keypad{};
+    std::array<uint8_t, 16> rpl{};           // SUPER-CHIP user flags
+    std::array<uint8_t, 16> audio_pattern{}; // XO-CHIP
+    uint16_t I               = 0;
+    uint16_t PC              = 0;
+    uint8_t sp               = 0;
+    uint8_t delay_timer      = 0;
+    uint8_t sound_timer      = 0;
+    uint8_t fx0a_key         = 0xFF;
+    bool fx0a_waiting        = false;
+    bool beeping             = false;
+    uint8_t planes           = 1;
+    uint8_t pitch            = 64;
+    uint32_t audio_phase     = 0;
+    uint32_t audio_frame_acc = 0;
+    bool audio_pattern_set   = false;
+    uint8_t padding2[3]      = {};
+
+    SaveState() { size = sizeof(SaveState); }
+
+    // True if every field the core indexes with, or reads as a bool, is in
+    // range. Files are raw bytes, so a corrupt or foreign one is rejected
+    // here rather than trusted.
+    bool valid() const;
+};
+
+static_assert(std::is_trivially_copyable<SaveState>::value, "save states are copied as raw bytes");
+static_assert(std::has_unique_object_representations<SaveState>::value,
+              "no padding: equal states must be equal byte for byte");
+static_assert(sizeof(SaveState) % 8 == 0, "the rewind delta coder works in 64-bit words");
+
+// Raw-bytes file I/O; both print the reason to stderr on failure. Reading
+// also fails for a state that is not valid().
+bool write_save_state(const std::string &path, const SaveState &state);
+bool read_save_state(const std::string &path, SaveState &state);
+
+#endif
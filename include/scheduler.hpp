@@ -0,0 +1,60 @@
+#ifndef SCHEDULER_H__
+#define SCHEDULER_H__
+
+#include <chrono>
+#include <cstdint>
+
+// Frame pacing statistics, in microseconds of wake-up error
+struct FrameStats {
+    uint64_t frames         = 0;
+    uint64_t overruns       = 0; // frames that missed their deadline by more than a frame
+    double mean_jitter_us   = 0.0;
+    double max_jitter_us    = 0.0;
+    double stddev_jitter_us = 0.0;
+};
+
+// Drives a 60 Hz frame loop. Emulated time is tracked in fixed point
+// (sixtieths of an instruction) so fractional instructions per frame carry
+// over instead of being truncated: 700 IPS yields exactly 700 instructions
+// per 60 frames. Each frame is one 60 Hz timer tick of emulated time.
+// Host pacing uses absolute deadlines with a hybrid sleep-then-spin wait.
+class Scheduler {
+public:
+    static constexpr uint32_t FRAME_HZ = 60;
+
+    explicit Scheduler(uint32_t insts_per_second) : insts_per_second_(insts_per_second) { restart(); }
+
+    void set_rate(uint32_t insts_per_second) { insts_per_second_ = insts_per_second; }
+
+    // Instructions to execute for the next frame of emulated time
+    uint32_t instructions_for_frame() {
+        cycle_acc_ += insts_per_second_;
+        const uint64_t count = cycle_acc_ / FRAME_HZ;
+        cycle_acc_ %= FRAME_HZ;
+        return static_cast<uint32_t>(count);
+    }
+
+    // Blocks until the current frame's deadline, then schedules the next one
+    void wait_for_next_frame();
+
+    // Re-anchors deadlines to now (after a pause or reset) without catch-up
+    void restart();
+
+    FrameStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint32_t insts_per_second_ = 0;
+    uint64_t cycle_acc_        = 0; // fractional instructions, in 1/FRAME_HZ units
+    Clock::time_point deadline_{};
+
+    // Running jitter statistics
+    uint64_t frames_   = 0;
+    uint64_t overruns_ = 0;
+    double sum_us_     = 0.0;
+    double sum_sq_us_  = 0.0;
+    double max_us_     = 0.0;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H__
+#define THREAD_POOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing thread pool. Every worker owns a deque: it takes
+// its own work from the back and, when that runs dry, steals from the front
+// of the others'. Tasks are expected to be coarse (a whole emulator run), so
+// each deque is guarded by its own mutex rather than a lock-free deque.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 threads = one per hardware thread
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool(); // finishes queued tasks, then joins
+
+    // Non-copyable
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t size() const { return threads_.size(); }
+
+    // Queues a task; submissions are spread round-robin over the workers
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished
+    void wait();
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_{ 0 };   // round-robin submission cursor
+    std::atomic<std::size_t> queued_{ 0 }; // tasks not yet taken; counted just before the push
+
+    std::mutex state_mutex_;
+    std::condition_variable work_cv_; // workers sleep here when idle
+    std::condition_variable done_cv_; // wait() sleeps here
+    std::size_t pending_ = 0;         // submitted but not finished, guarded by state_mutex_
+    bool stop_           = false;
+
+    bool try_take(std::size_t self, Task &task);
+    void worker_loop(std::size_t self);
+};
+
+#endif
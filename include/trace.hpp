@@ -0,0 +1,91 @@
+#ifndef TRACE_H__
+#define TRACE_H__
+
+#include "ring_buffer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Trace file header, followed by TraceRecords until the end of the file
+struct TraceHeader {
+    static constexpr uint32_t MAGIC   = 0x52543843; // "C8TR" in little-endian
+    static constexpr uint16_t VERSION = 1;
+
+    uint32_t magic       = MAGIC;
+    uint16_t version     = VERSION;
+    uint16_t record_size = 0;
+    uint64_t rom_hash    = 0;
+};
+
+// One executed instruction. `reg` is the lowest V register the instruction
+// changed (VF only if nothing else changed), 0xFF if none. Gaps in `seq` mark
+// records dropped because the flusher fell behind.
+struct TraceRecord {
+    uint32_t seq      = 0;
+    uint16_t pc       = 0;
+    uint16_t opcode   = 0;
+    uint16_t I        = 0; // after the instruction
+    uint8_t reg       = 0xFF;
+    uint8_t value     = 0; // new value of V[reg]
+    uint8_t vf        = 0; // VF after the instruction
+    uint8_t sp        = 0; // stack depth after the instruction
+    uint16_t reserved = 0;
+};
+
+static_assert(std::is_trivially_copyable<TraceHeader>::value && sizeof(TraceHeader) == 16, "raw on-disk layout");
+static_assert(std::is_trivially_copyable<TraceRecord>::value && sizeof(TraceRecord) == 16, "raw on-disk layout");
+
+// Execution tracer. The emulation thread pushes records into a lock-free
+// ring; a background thread drains it to disk in large writes. When the
+// ring is full, records are dropped and counted rather than stalling a
+// real-time frontend; a lossless tracer waits for the flusher instead.
+class Tracer {
+public:
+    static constexpr std::size_t RING_RECORDS = 1 << 16; // 1 MiB
+
+    explicit Tracer(bool lossless = false);
+    ~Tracer() { stop(); }
+
+    // Non-copyable
+    Tracer(const Tracer &)            = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    // Opens `path` and starts the flusher; prints the reason to stderr on failure
+    bool start(const std::string &path, uint64_t rom_hash);
+
+    // Writes out everything recorded so far and closes the file
+    void stop();
+
+    bool active() const { return flusher_.joinable(); }
+
+    // Emulation thread only
+    void record(const TraceRecord &r) {
+        while (!ring_->push(r)) {
+            if (!lossless_) {
+                dropped_++;
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t dropped() const { return dropped_; }
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<SpscRing<TraceRecord, RING_RECORDS>> ring_;
+    bool lossless_ = false;
+    std::thread flusher_;
+    std::atomic<bool> stopping_{ false };
+    std::atomic<uint64_t> written_{ 0 };
+    uint64_t dropped_ = 0;
+
+    void flush_loop(std::FILE *file);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef TRIPLE_BUFFER_H__
+#define TRIPLE_BUFFER_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-writer / single-reader handoff of whole values, such as
+// completed frames. The writer fills back() and publish()es it; the reader
+// calls update() to take the newest published value and reads front().
+// Neither side ever waits: a writer that outpaces the reader overwrites the
+// value not yet taken, and a reader that outpaces the writer keeps its
+// current one.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer: the slot being filled, never seen by the reader
+    T &back() { return slots_[back_]; }
+
+    // Writer: hands back() over as the newest value
+    void publish() {
+        back_ = static_cast<uint8_t>(middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX);
+    }
+
+    // Reader: takes the newest value if one was published since the last
+    // call; returns false (front() unchanged) otherwise
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return false;
+        front_ = static_cast<uint8_t>(middle_.exchange(front_, std::memory_order_acq_rel) & INDEX);
+        return true;
+    }
+
+    // Reader: the value taken by the last successful update()
+    const T &front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4; // middle holds a value the reader has not taken
+
+    std::array<T, 3> slots_{ { T(), T(), T() } };
+    uint8_t back_  = 0; // writer only
+    uint8_t front_ = 1; // reader only
+    alignas(64) std::atomic<uint8_t> middle_{ 2 };
+};
+
+#endif
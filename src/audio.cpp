@@ -2,7 +2,9 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_audio.h>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <vector>
 
 Audio::Audio(const Config &config) {
     if (SDL_Init(SDL_INIT_AUDIO) != 0) {
@@ -11,23 +13,24 @@ Audio::Audio(const Config &config) {
     }
 
     want_.freq = static_cast<int>(config.audio_sample_rate);
-    want_.format = AUDIO_S16LSB;
+    want_.format = AUDIO_S16SYS;
     want_.channels = 1;
     want_.samples = 512;
     want_.callback = audioCallback;
-    want_.userdata =
-        const_cast<Config *>(&config); // config lifetime outlives Audio
+    want_.userdata = this;
 
-    // Open audio device
+    // Open audio device; SDL converts if the hardware wants another format
     dev_ = SDL_OpenAudioDevice(nullptr, 0, &want_, &have_, 0);
     if (dev_ == 0) {
         std::cerr << "Could not open audio device: " << SDL_GetError() << '\n';
         return;
     }
 
-    if (want_.format != have_.format || want_.channels != have_.channels) {
-        std::cerr << "Audio device did not grant requested format.\n";
-    }
+    // Prime with a frame of silence so the first callbacks don't underrun
+    const std::vector<int16_t> silence(config.audio_sample_rate / 60, 0);
+    ring_.push(silence.data(), silence.size());
+
+    SDL_PauseAudioDevice(dev_, 0); // runs for the device's whole lifetime
 }
 
 Audio::~Audio() {
@@ -37,33 +40,20 @@ Audio::~Audio() {
     SDL_Quit();
 }
 
+std::size_t Audio::push(const int16_t *samples, std::size_t count) {
+    return ring_.push(samples, count);
+}
+
+// SDL audio thread: copy out whatever the emulator produced, pad with silence
 void Audio::audioCallback(void *userdata, Uint8 *stream, int len) {
-    const Config *config = static_cast<const Config *>(userdata);
+    Audio *audio = static_cast<Audio *>(userdata);
 
     auto *audio_data = reinterpret_cast<int16_t *>(stream);
-    static uint32_t running_sample_index = 0;
+    const std::size_t wanted = static_cast<std::size_t>(len) / sizeof(int16_t);
+    const std::size_t got = audio->ring_.pop(audio_data, wanted);
 
-    const int32_t period = static_cast<int32_t>(config->audio_sample_rate /
-                                                config->square_wave_freq);
-    const int32_t half_period = period / 2;
-
-    const int sample_count = len / 2;
-    for (int i = 0; i < sample_count; ++i) {
-        audio_data[i] = ((running_sample_index++ / half_period) % 2)
-                            ? config->volume
-                            : static_cast<int16_t>(-config->volume);
-    }
-}
-
-void Audio::play() {
-    if (dev_) {
-        SDL_PauseAudioDevice(dev_, 0); // Unpause audio
-    }
-}
-
-// stop function
-void Audio::stop() {
-    if (dev_) {
-        SDL_PauseAudioDevice(dev_, 1); // Pause audio
+    if (got < wanted) {
+        std::memset(audio_data + got, 0, (wanted - got) * sizeof(int16_t));
+        audio->underruns_.fetch_add(1, std::memory_order_relaxed);
     }
 }
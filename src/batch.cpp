@@ -0,0 +1,234 @@
+#include "../include/chip8.hpp"
+#include "../include/config.hpp"
+#include "../include/input_script.hpp"
+#include "../include/rom_library.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Batch regression runner: emulates many ROMs as independent Chip8
+// instances spread over a work-stealing thread pool, each for a fixed number
+// of frames with a fixed RNG seed and optional scripted input, and prints one
+// framebuffer hash per ROM. With --golden the hashes are checked against a
+// file in the same format as this program's output. Each ROM file is read
+// once and shared by its instances; with --rom-db, ROMs found in the
+// database run with its settings unless the command line overrides them.
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct BatchOptions {
+    std::vector<std::string> roms;
+    std::size_t threads = 0; // 0 = all hardware threads
+    uint32_t repeat     = 1; // instances per ROM
+    uint32_t seed       = 0;
+    std::string script_path;
+    std::string golden_path;
+};
+
+struct RunResult {
+    uint64_t hash         = 0;
+    uint64_t instructions = 0;
+    uint64_t idle         = 0; // of which skipped in idle loops
+    bool loaded           = false;
+};
+
+// Picks out the batch-only options and the ROM/directory arguments; the
+// rest is left to set_config_from_args
+bool parse_batch_args(BatchOptions &options, int argc, char **argv) {
+    std::vector<std::string> inputs;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) {
+                inputs.push_back(arg);
+                continue;
+            }
+            if (i + 1 >= argc) break;
+            const std::string value = argv[++i];
+            if (arg == "--threads") options.threads = std::stoul(value);
+            else if (arg == "--repeat") options.repeat = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--script") options.script_path = value;
+            else if (arg == "--golden") options.golden_path = value;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Directories are searched recursively for .ch8 files, in sorted order
+    for (const std::string &input : inputs) {
+        if (!fs::is_directory(input)) {
+            options.roms.push_back(input);
+            continue;
+        }
+        std::vector<std::string> found;
+        for (const auto &entry : fs::recursive_directory_iterator(input))
+            if (entry.is_regular_file() && entry.path().extension() == ".ch8")
+                found.push_back(entry.path().generic_string());
+        std::sort(found.begin(), found.end());
+        options.roms.insert(options.roms.end(), found.begin(), found.end());
+    }
+    if (options.repeat == 0) options.repeat = 1;
+    return true;
+}
+
+// Same frame loop as chip8-headless, plus scripted input
+RunResult run_instance(const std::shared_ptr<const RomImage> &rom, const Config &config, const InputScript &script,
+                       uint32_t seed) {
+    RunResult result;
+    Chip8 chip8(rom);
+    if (chip8.get_state() == EmulatorState::QUIT) return result;
+    chip8.seed_rng(seed);
+
+    Scheduler scheduler(config.insts_per_second);
+    std::size_t cursor = 0;
+    for (uint64_t frame = 0; frame < config.max_frames && chip8.get_state() != EmulatorState::QUIT; ++frame) {
+        script.apply(chip8, frame, cursor);
+        const uint32_t batch = scheduler.instructions_for_frame();
+        chip8.run(config, batch);
+        result.instructions += batch;
+        chip8.update_timers();
+    }
+
+    result.hash   = chip8.display_hash();
+    result.idle   = chip8.perf().idle_instructions;
+    result.loaded = true;
+    return result;
+}
+
+// Golden file: `<hash> <rom path>` per line, as printed by this program
+bool load_golden(const std::string &path, std::unordered_map<std::string, uint64_t> &golden) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: golden file \"" << path << "\" cannot be opened.\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string hash, rom;
+        if (!(fields >> hash) || hash[0] == '#') continue;
+        std::getline(fields >> std::ws, rom);
+        golden[rom] = std::stoull(hash, nullptr, 16);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <rom|dir>... [--frames N] [--threads N] [--repeat N]"
+                  << " [--seed N] [--script FILE] [--golden FILE] [options]\n";
+        return EXIT_FAILURE;
+    }
+
+    Config config;
+    BatchOptions options;
+    if (!set_config_from_args(config, argc, argv) || !parse_batch_args(options, argc, argv))
+        return EXIT_FAILURE;
+    if (config.max_frames == 0) config.max_frames = 600;
+
+    InputScript script;
+    if (!options.script_path.empty() && !script.load(options.script_path))
+        return EXIT_FAILURE;
+
+    std::unordered_map<std::string, uint64_t> golden;
+    if (!options.golden_path.empty() && !load_golden(options.golden_path, golden))
+        return EXIT_FAILURE;
+
+    if (options.roms.empty()) {
+        std::cerr << "Error: no ROMs found.\n";
+        return EXIT_FAILURE;
+    }
+
+    RomLibrary library;
+    if (!config.rom_db_path.empty() && !library.load_database(config.rom_db_path))
+        return EXIT_FAILURE;
+
+    // Images and settings are resolved up front; a ROM that fails to open
+    // is reported as a load error like any other
+    std::vector<std::shared_ptr<const RomImage>> images(options.roms.size());
+    std::vector<Config> configs(options.roms.size(), config);
+    for (std::size_t r = 0; r < options.roms.size(); ++r) {
+        images[r] = library.open(options.roms[r]);
+        if (!images[r]) continue;
+        library.configure(configs[r], *images[r], argc, argv);
+        if (configs[r].max_frames == 0) configs[r].max_frames = 600;
+    }
+
+    // One slot per instance, written only by the task that owns it
+    const std::size_t instances = options.roms.size() * options.repeat;
+    std::vector<RunResult> results(instances);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t threads;
+    {
+        ThreadPool pool(options.threads);
+        threads = pool.size();
+        for (std::size_t i = 0; i < instances; ++i) {
+            pool.submit([&, i] {
+                const std::size_t r = i / options.repeat;
+                results[i]          = run_instance(images[r], configs[r], script, options.seed);
+            });
+        }
+        pool.wait();
+    }
+    const auto end         = std::chrono::steady_clock::now();
+    const double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+    // Report per ROM; repeats of one ROM must agree or the core is not deterministic
+    uint64_t instructions = 0, idle = 0;
+    std::size_t failures  = 0;
+    std::cout << std::hex << std::setfill('0');
+    for (std::size_t r = 0; r < options.roms.size(); ++r) {
+        const std::string &rom = options.roms[r];
+        const RunResult &first = results[r * options.repeat];
+        const char *status     = nullptr;
+
+        for (uint32_t k = 0; k < options.repeat; ++k) {
+            const RunResult &run = results[r * options.repeat + k];
+            instructions += run.instructions;
+            idle += run.idle;
+            if (run.loaded != first.loaded || run.hash != first.hash) status = "NONDETERMINISTIC";
+        }
+        if (!first.loaded) {
+            status = "LOAD-ERROR";
+        } else if (!status && !golden.empty()) {
+            const auto it = golden.find(rom);
+            status        = it == golden.end() ? "NEW" : it->second != first.hash ? "MISMATCH" : nullptr;
+        }
+        if (status && std::string(status) != "NEW") ++failures;
+
+        std::cout << std::setw(16) << first.hash << ' ' << rom;
+        if (status) std::cout << "  [" << status << ']';
+        std::cout << '\n';
+    }
+    std::cout << std::dec << std::setfill(' ');
+
+    const double ips = elapsed_s > 0.0 ? static_cast<double>(instructions) / elapsed_s : 0.0;
+    std::cerr << std::fixed << std::setprecision(3)
+              << instances << " instances on " << threads << " threads in "
+              << elapsed_s * 1000.0 << " ms, " << std::setprecision(0) << ips << " instructions/s ("
+              << std::setprecision(1) << (instructions ? 100.0 * static_cast<double>(idle) / static_cast<double>(instructions) : 0.0)
+              << "% idle)";
+    if (!golden.empty()) std::cerr << ", " << failures << " failure(s)";
+    std::cerr << '\n';
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+#include "../include/chip8.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Basic-block engine
+// ---------------------------------------------------------------------------
+// Straight-line code is decoded once into a contiguous run of handler/operand
+// pairs and executed as a unit: one cache lookup per block instead of per
+// instruction. Handlers are shared with the interpreter, so state stays
+// bit-identical.
+
+// Ops that may change PC (or re-execute themselves) close a block, as does
+// XO-CHIP's F000, whose second word is data. DXYN and FX0A also end one so
+// frontends observe draws / key waits at block edges.
+bool Chip8::ends_block(uint16_t opcode) {
+    switch ((opcode >> 12) & 0x0F) {
+        case 0x00: return (opcode & 0x00FF) == 0xEE || opcode == 0x00FD;
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+        case 0x05:
+        case 0x09:
+        case 0x0B:
+        case 0x0D:
+        case 0x0E: return true;
+        case 0x0F: return (opcode & 0x00FF) == 0x0A || opcode == 0xF000;
+        default: return false;
+    }
+}
+
+void Chip8::count_block_runs() {
+    for (Block &block : blocks_) {
+        if (block.runs == 0) continue;
+        for (uint32_t i = 0; i < block.length; ++i) perf_.op_class[block_ops_[block.first + i].opcode >> 12] += block.runs;
+        block.runs = 0;
+    }
+}
+
+PerfCounters &Chip8::perf() {
+    count_block_runs();
+    if (jit_) jit_->drain_counts(perf_.op_class);
+    return perf_;
+}
+
+void Chip8::flush_blocks() {
+    count_block_runs();
+    if (jit_) jit_->clear();
+    blocks_.clear();
+    block_ops_.clear();
+    std::fill(block_at_.begin(), block_at_.end(), -1);
+    std::fill(block_cover_.begin(), block_cover_.end(), uint8_t{ 0 });
+    blocks_dirty_ = false;
+}
+
+Chip8::Block &Chip8::build_block(uint16_t start) {
+    Block block;
+    block.start = start;
+    block.first = static_cast<uint32_t>(block_ops_.size());
+
+    uint16_t addr = start;
+    while (addr >= ROM_START && addr < RAM_SIZE - 1 && block.length < MAX_BLOCK_LEN) {
+        const uint16_t opcode = fetch(addr);
+        block_ops_.push_back(decode(opcode, dialect_));
+        block_cover_[addr - ROM_START]     = 1;
+        block_cover_[addr + 1 - ROM_START] = 1;
+        ++block.length;
+        addr += 2;
+        if (ends_block(opcode)) break;
+    }
+
+    block_at_[start - ROM_START] = static_cast<int32_t>(blocks_.size());
+    blocks_.push_back(block);
+    return blocks_.back();
+}
+
+// Executes at most `budget` instructions from the block at PC_. Returns the
+// number executed, or 0 when PC_ lies outside the program region.
+uint32_t Chip8::run_block(const Config &config, uint32_t budget) {
+    const uint16_t pc = PC_;
+    if (pc < ROM_START || pc >= RAM_SIZE - 1) return 0;
+
+    if (blocks_dirty_) flush_blocks();
+
+    const int32_t index = block_at_[pc - ROM_START];
+    Block &block        = index >= 0 ? blocks_[static_cast<std::size_t>(index)] : build_block(pc);
+
+    const uint32_t count   = std::min<uint32_t>(block.length, budget);
+    const DecodedInst *ops = &block_ops_[block.first];
+
+    uint32_t executed = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        PC_ = static_cast<uint16_t>(block.start + 2 * (i + 1));
+        ops[i].fn(*this, ops[i], config);
+
+        // The op rewrote code covered by a block: the rest may be stale
+        if (blocks_dirty_) {
+            executed = i + 1;
+            break;
+        }
+    }
+
+    // Whole runs are counted per block; cut-short ones op by op
+    if (executed == block.length)
+        block.runs++;
+    else
+        for (uint32_t i = 0; i < executed; ++i) perf_.op_class[ops[i].opcode >> 12]++;
+    return executed;
+}
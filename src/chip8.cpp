@@ -1,190 +1,133 @@
 #include "../include/chip8.hpp"
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_keycode.h>
+#include "../include/fontset.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
 #include <iostream>
-
-// ---------------------------------------------------------------------------
-// Fontset
-// ---------------------------------------------------------------------------
-// clang-format off
-static constexpr std::array<uint8_t, 80> FONTSET = {{
-    0xF0, 0x90, 0x90, 0x90, 0xF0,  // 0
-    0x20, 0x60, 0x20, 0x20, 0x70,  // 1
-    0xF0, 0x10, 0xF0, 0x80, 0xF0,  // 2
-    0xF0, 0x10, 0xF0, 0x10, 0xF0,  // 3
-    0x90, 0x90, 0xF0, 0x10, 0x10,  // 4
-    0xF0, 0x80, 0xF0, 0x10, 0xF0,  // 5
-    0xF0, 0x80, 0xF0, 0x90, 0xF0,  // 6
-    0xF0, 0x10, 0x20, 0x40, 0x40,  // 7
-    0xF0, 0x90, 0xF0, 0x90, 0xF0,  // 8
-    0xF0, 0x90, 0xF0, 0x10, 0xF0,  // 9
-    0xF0, 0x90, 0xF0, 0x90, 0x90,  // A
-    0xE0, 0x90, 0xE0, 0x90, 0xE0,  // B
-    0xF0, 0x80, 0x80, 0x80, 0xF0,  // C
-    0xE0, 0x90, 0x90, 0x90, 0xE0,  // D
-    0xF0, 0x80, 0xF0, 0x80, 0xF0,  // E
-    0xF0, 0x80, 0xF0, 0x80, 0x80,  // F
-}};
-// clang-format on
+#include <utility>
 
 // ---------------------------------------------------------------------------
 // Construction
 // ---------------------------------------------------------------------------
-Chip8::Chip8(const std::string &rom_path, Audio &audio)
-    : rom_name_(rom_path), audio_(audio) {
+Chip8::Chip8(const std::string &rom_path)
+    : Chip8(RomImage::open(rom_path)) {}
+
+Chip8::Chip8(std::shared_ptr<const RomImage> rom)
+    : rom_(std::move(rom)) {
     load_fontset();
-    load_rom(rom_path);
+    load_rom();
+    boot_vip_hires();
 }
 
 void Chip8::load_fontset() {
     std::copy(FONTSET.begin(), FONTSET.end(), ram_.begin());
+    std::copy(BIG_FONTSET.begin(), BIG_FONTSET.end(), ram_.begin() + BIG_FONT_START);
 }
 
-void Chip8::load_rom(const std::string &rom_path) {
-    std::ifstream rom(rom_path, std::ios::binary | std::ios::ate);
-    if (!rom) {
-        std::cerr << "Error: ROM \"" << rom_path << "\" is invalid or does not exist.\n";
+// Copies the ROM image into RAM; RomImage::open has already reported a
+// missing or unreadable file
+void Chip8::load_rom() {
+    if (!rom_) {
         state_ = EmulatorState::QUIT;
         return;
     }
 
-    const auto rom_size            = static_cast<std::size_t>(rom.tellg());
     constexpr std::size_t max_size = RAM_SIZE - ROM_START;
-    if (rom_size > max_size) {
-        std::cerr << "Error: ROM \"" << rom_path << "\" is too large ("
-                  << rom_size << " bytes; max " << max_size << ").\n";
+    if (rom_->size() > max_size) {
+        std::cerr << "Error: ROM \"" << rom_->path() << "\" is too large ("
+                  << rom_->size() << " bytes; max " << max_size << ").\n";
         state_ = EmulatorState::QUIT;
         return;
     }
 
-    rom.seekg(0, std::ios::beg);
-    rom.read(reinterpret_cast<char *>(&ram_[ROM_START]), static_cast<std::streamsize>(rom_size));
+    std::copy(rom_->data(), rom_->data() + rom_->size(), ram_.begin() + ROM_START);
+    rom_hash_ = rom_->hash();
+}
+
+// ROMs for the COSMAC VIP two-page hires mode (64x64) start with a jump over
+// a patch to the VIP's interpreter. The patch is emulated instead of run:
+// the screen becomes 64x64 and execution starts after it. The patch's
+// clear-screen routine is called as 0230, which decodes as 00E0.
+void Chip8::boot_vip_hires() {
+    if (fetch(ROM_START) != 0x1260) return;
+    display_.resize(LORES_W, HIRES_H);
+    PC_ = VIP_HIRES_ENTRY;
 }
 
 // ---------------------------------------------------------------------------
 // Input
 // ---------------------------------------------------------------------------
-void Chip8::handle_input(Config &config) {
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-
-            case SDL_QUIT:
-                state_ = EmulatorState::QUIT;
-                break;
-
-            case SDL_KEYDOWN:
-                switch (event.key.keysym.sym) {
-
-                    case SDLK_ESCAPE:
-                        state_ = EmulatorState::QUIT;
-                        break;
-
-                    case SDLK_SPACE:
-                        if (state_ == EmulatorState::RUNNING) {
-                            state_ = EmulatorState::PAUSED;
-                            std::cout << "========= PAUSED =========\n";
-                        } else {
-                            state_ = EmulatorState::RUNNING;
-                            std::cout << "========= RUNNING =========\n";
-                        }
-                        break;
-
-                    case SDLK_EQUALS:
-                        reset();
-                        break;
-
-                    case SDLK_j:
-                        if (config.color_lerp_rate > 0.1f) config.color_lerp_rate -= 0.1f;
-                        break;
-
-                    case SDLK_k:
-                        if (config.color_lerp_rate < 1.0f) config.color_lerp_rate += 0.1f;
-                        break;
-
-                    case SDLK_o:
-                        if (config.volume > 0) config.volume -= 500;
-                        break;
-
-                    case SDLK_p:
-                        if (config.volume < INT16_MAX) config.volume += 500;
-                        break;
-
-                    // CHIP-8 keypad (QWERTY layout)
-                    case SDLK_1: keypad_[0x1] = true; break;
-                    case SDLK_2: keypad_[0x2] = true; break;
-                    case SDLK_3: keypad_[0x3] = true; break;
-                    case SDLK_4: keypad_[0xC] = true; break;
-
-                    case SDLK_q: keypad_[0x4] = true; break;
-                    case SDLK_w: keypad_[0x5] = true; break;
-                    case SDLK_e: keypad_[0x6] = true; break;
-                    case SDLK_r: keypad_[0xD] = true; break;
-
-                    case SDLK_a: keypad_[0x7] = true; break;
-                    case SDLK_s: keypad_[0x8] = true; break;
-                    case SDLK_d: keypad_[0x9] = true; break;
-                    case SDLK_f: keypad_[0xE] = true; break;
-
-                    case SDLK_z: keypad_[0xA] = true; break;
-                    case SDLK_x: keypad_[0x0] = true; break;
-                    case SDLK_c: keypad_[0xB] = true; break;
-                    case SDLK_v: keypad_[0xF] = true; break;
-
-                    default: break;
-                }
-                break; // SDL_KEYDOWN
-
-            case SDL_KEYUP:
-                switch (event.key.keysym.sym) {
-                    case SDLK_1: keypad_[0x1] = false; break;
-                    case SDLK_2: keypad_[0x2] = false; break;
-                    case SDLK_3: keypad_[0x3] = false; break;
-                    case SDLK_4: keypad_[0xC] = false; break;
-
-                    case SDLK_q: keypad_[0x4] = false; break;
-                    case SDLK_w: keypad_[0x5] = false; break;
-                    case SDLK_e: keypad_[0x6] = false; break;
-                    case SDLK_r: keypad_[0xD] = false; break;
-
-                    case SDLK_a: keypad_[0x7] = false; break;
-                    case SDLK_s: keypad_[0x8] = false; break;
-                    case SDLK_d: keypad_[0x9] = false; break;
-                    case SDLK_f: keypad_[0xE] = false; break;
-
-                    case SDLK_z: keypad_[0xA] = false; break;
-                    case SDLK_x: keypad_[0x0] = false; break;
-                    case SDLK_c: keypad_[0xB] = false; break;
-                    case SDLK_v: keypad_[0xF] = false; break;
-
-                    default: break;
-                }
-                break; // SDL_KEYUP
-
-            default:
-                break;
-        }
+void Chip8::toggle_pause() {
+    if (state_ == EmulatorState::RUNNING) {
+        state_ = EmulatorState::PAUSED;
+        std::cout << "========= PAUSED =========\n";
+    } else if (state_ == EmulatorState::PAUSED) {
+        state_ = EmulatorState::RUNNING;
+        std::cout << "========= RUNNING =========\n";
     }
 }
 
+uint16_t Chip8::keypad_mask() const {
+    uint16_t mask = 0;
+    for (uint8_t k = 0; k < 16; ++k)
+        if (keypad_[k]) mask |= static_cast<uint16_t>(1u << k);
+    return mask;
+}
+
 // ---------------------------------------------------------------------------
 // Timers
 // ---------------------------------------------------------------------------
 void Chip8::update_timers() {
     if (delay_timer_ > 0) --delay_timer_;
 
-    if (sound_timer_ > 0) {
-        --sound_timer_;
-        audio_.play();
-    } else {
-        audio_.stop();
+    beeping_ = sound_timer_ > 0;
+    if (beeping_) --sound_timer_;
+}
+
+// ---------------------------------------------------------------------------
+// Audio
+// ---------------------------------------------------------------------------
+std::size_t Chip8::render_audio(const Config &config, int16_t *out, std::size_t capacity) {
+    audio_frame_acc_ += config.audio_sample_rate;
+    std::size_t count = audio_frame_acc_ / 60;
+    audio_frame_acc_ %= 60;
+    if (count > capacity) count = capacity;
+
+    if (!beeping_) {
+        std::fill(out, out + count, int16_t{ 0 });
+        return count;
     }
+
+    const int16_t high = config.volume;
+    const int16_t low  = static_cast<int16_t>(-config.volume);
+
+    // XO-CHIP: the 128-bit pattern from F002, MSB first, looped at
+    // 4000 * 2^((pitch - 64) / 48) bits per second. The phase wraps once per
+    // pattern: the top 7 bits pick the bit.
+    if (audio_pattern_set_ && config.current_extension == Extension::XOCHIP) {
+        const double rate   = 4000.0 * std::exp2((static_cast<int>(pitch_) - 64) / 48.0);
+        const uint32_t step = config.audio_sample_rate
+                                  ? static_cast<uint32_t>(rate * double(1u << 25) / config.audio_sample_rate)
+                                  : 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const uint32_t bit = audio_phase_ >> 25;
+            out[i]             = (audio_pattern_[bit >> 3] >> (7 - (bit & 7))) & 1 ? high : low;
+            audio_phase_ += step;
+        }
+        return count;
+    }
+
+    const uint32_t step = config.audio_sample_rate
+                              ? static_cast<uint32_t>((uint64_t{ config.square_wave_freq } << 32) / config.audio_sample_rate)
+                              : 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = (audio_phase_ & 0x80000000u) ? high : low;
+        audio_phase_ += step;
+    }
+    return count;
 }
 
 // ---------------------------------------------------------------------------
@@ -192,7 +135,7 @@ void Chip8::update_timers() {
 // ---------------------------------------------------------------------------
 void Chip8::reset() {
     ram_.fill(0);
-    display_.fill(false);
+    display_.resize(LORES_W, LORES_H);
     stack_.fill(0);
     keypad_.fill(false);
     V_.fill(0);
@@ -203,385 +146,836 @@ void Chip8::reset() {
     delay_timer_ = 0;
     sound_timer_ = 0;
     draw_        = true;
+    beeping_     = false;
+    audio_phase_ = 0;
+
+    planes_            = 1;
+    pitch_             = 64;
+    audio_pattern_set_ = false;
+    audio_pattern_.fill(0);
 
     // FX0A state must also be reset or re-waiting after reset is a bug
     fx0a_waiting_ = false;
     fx0a_key_     = 0xFF;
+    idle_misses_.fill({});
 
     // Fontset must be reloaded — ram was just zeroed
     load_fontset();
 
-    if (!rom_name_.empty())
-        load_rom(rom_name_);
+    if (rom_) {
+        load_rom();
+        boot_vip_hires();
+    }
+    flush_decode_cache();
+    flush_blocks();
+    flush_sprites();
 
     std::cout << "========= CHIP-8 RESET =========\n";
 }
 
 // ---------------------------------------------------------------------------
-// Debug
+// Save states
 // ---------------------------------------------------------------------------
-#ifdef DEBUG
-void Chip8::print_debug_info() const {
-    // Use std::cout throughout — no printf mixing
-    std::cout << std::hex << std::uppercase;
-    std::cout << "Address: 0x" << (PC_ - 2)
-              << "  Opcode: 0x" << inst_.opcode
-              << "  Desc: ";
-
-    switch ((inst_.opcode >> 12) & 0x0F) {
-        case 0x00:
-            if (inst_.NN == 0xE0)
-                std::cout << "Clear screen";
-            else if (inst_.NN == 0xEE)
-                std::cout << "Return from subroutine to 0x" << stack_[sp_ - 1];
-            break;
-        case 0x01: std::cout << "Jump to 0x" << inst_.NNN; break;
-        case 0x02: std::cout << "Call subroutine 0x" << inst_.NNN; break;
-        case 0x03: std::cout << "Skip if V" << +inst_.X << " == 0x" << +inst_.NN; break;
-        case 0x04: std::cout << "Skip if V" << +inst_.X << " != 0x" << +inst_.NN; break;
-        case 0x05: std::cout << "Skip if V" << +inst_.X << " == V" << +inst_.Y; break;
-        case 0x06: std::cout << "V" << +inst_.X << " = 0x" << +inst_.NN; break;
-        case 0x07: std::cout << "V" << +inst_.X << " += 0x" << +inst_.NN; break;
-        case 0x08:
-            switch (inst_.N) {
-                case 0x0: std::cout << "V" << +inst_.X << " = V" << +inst_.Y; break;
-                case 0x1: std::cout << "V" << +inst_.X << " |= V" << +inst_.Y; break;
-                case 0x2: std::cout << "V" << +inst_.X << " &= V" << +inst_.Y; break;
-                case 0x3: std::cout << "V" << +inst_.X << " ^= V" << +inst_.Y; break;
-                case 0x4: std::cout << "V" << +inst_.X << " += V" << +inst_.Y << " (carry->VF)"; break;
-                case 0x5: std::cout << "V" << +inst_.X << " -= V" << +inst_.Y << " (borrow->VF)"; break;
-                case 0x6: std::cout << "V" << +inst_.X << " >>= 1 (bit->VF)"; break;
-                case 0x7: std::cout << "V" << +inst_.X << " = V" << +inst_.Y << " - V" << +inst_.X; break;
-                case 0xE: std::cout << "V" << +inst_.X << " <<= 1 (bit->VF)"; break;
-                default: std::cout << "Unknown 8XYN (N=0x" << +inst_.N << ")"; break;
-            }
-            break;
-        case 0x09: std::cout << "Skip if V" << +inst_.X << " != V" << +inst_.Y; break;
-        case 0x0A: std::cout << "I = 0x" << inst_.NNN; break;
-        case 0x0B: std::cout << "PC = 0x" << inst_.NNN << " + V0"; break;
-        case 0x0C: std::cout << "V" << +inst_.X << " = rand & 0x" << +inst_.NN; break;
-        case 0x0D: std::cout << "Draw " << +inst_.N << " rows at V" << +inst_.X << ",V" << +inst_.Y; break;
-        case 0x0E:
-            if (inst_.NN == 0x9E)
-                std::cout << "Skip if key V" << +inst_.X << " pressed";
-            else if (inst_.NN == 0xA1)
-                std::cout << "Skip if key V" << +inst_.X << " not pressed";
-            break;
-        case 0x0F:
-            switch (inst_.NN) {
-                case 0x07: std::cout << "V" << +inst_.X << " = delay_timer"; break;
-                case 0x0A: std::cout << "Wait for key -> V" << +inst_.X; break;
-                case 0x15: std::cout << "delay_timer = V" << +inst_.X; break;
-                case 0x18: std::cout << "sound_timer = V" << +inst_.X; break;
-                case 0x1E: std::cout << "I += V" << +inst_.X; break;
-                case 0x29: std::cout << "I = sprite addr for V" << +inst_.X; break;
-                case 0x33: std::cout << "BCD(V" << +inst_.X << ") -> [I]"; break;
-                case 0x55: std::cout << "Dump V0-V" << +inst_.X << " to [I]"; break;
-                case 0x65: std::cout << "Load V0-V" << +inst_.X << " from [I]"; break;
-                default: std::cout << "Unknown FX (NN=0x" << +inst_.NN << ")"; break;
-            }
-            break;
-        default:
-            std::cout << "Unimplemented opcode 0x" << inst_.opcode;
-            break;
+void Chip8::save_state(SaveState &state) const {
+    state.ram     = ram_;
+    state.display = display_;
+    state.display.clear_dirty(); // frontend bookkeeping, not machine state
+    state.rng     = rng_;
+
+    state.stack             = stack_;
+    state.V                 = V_;
+    state.keypad            = keypad_;
+    state.rpl               = rpl_;
+    state.audio_pattern     = audio_pattern_;
+    state.I                 = I_;
+    state.PC                = PC_;
+    state.sp                = sp_;
+    state.delay_timer       = delay_timer_;
+    state.sound_timer       = sound_timer_;
+    state.fx0a_key          = fx0a_key_;
+    state.fx0a_waiting      = fx0a_waiting_;
+    state.beeping           = beeping_;
+    state.planes            = planes_;
+    state.pitch             = pitch_;
+    state.audio_pattern_set = audio_pattern_set_;
+    state.audio_phase       = audio_phase_;
+    state.audio_frame_acc   = audio_frame_acc_;
+}
+
+bool Chip8::load_state(const SaveState &state) {
+    if (!state.valid()) return false;
+
+    // Compare RAM in 4 KiB pages, then 64-byte blocks; changed bytes go
+    // through write_ram so decoded instructions, blocks and JIT code covering
+    // them are dropped. Run-ahead restores every frame, and usually only a
+    // few blocks differ.
+    for (std::size_t page = 0; page < RAM_SIZE; page += 4096) {
+        if (std::memcmp(&ram_[page], &state.ram[page], 4096) == 0) continue;
+        for (std::size_t addr = page; addr < page + 4096; addr += 64) {
+            if (std::memcmp(&ram_[addr], &state.ram[addr], 64) == 0) continue;
+            for (std::size_t i = addr; i < addr + 64; ++i)
+                if (ram_[i] != state.ram[i]) write_ram(static_cast<uint16_t>(i), state.ram[i]);
+        }
     }
 
-    std::cout << std::dec << '\n';
+    display_.assign(state.display);
+    rng_ = state.rng;
+    rand_byte_.reset();
+
+    stack_             = state.stack;
+    V_                 = state.V;
+    keypad_            = state.keypad;
+    rpl_               = state.rpl;
+    audio_pattern_     = state.audio_pattern;
+    I_                 = state.I;
+    PC_                = state.PC;
+    sp_                = state.sp;
+    delay_timer_       = state.delay_timer;
+    sound_timer_       = state.sound_timer;
+    fx0a_key_          = state.fx0a_key;
+    fx0a_waiting_      = state.fx0a_waiting;
+    beeping_           = state.beeping;
+    planes_            = state.planes;
+    pitch_             = state.pitch;
+    audio_pattern_set_ = state.audio_pattern_set;
+    audio_phase_       = state.audio_phase;
+    audio_frame_acc_   = state.audio_frame_acc;
+    draw_              = true; // display rows may have changed
+    return true;
+}
+
+uint64_t Chip8::display_hash() const {
+    return display_.hash();
 }
-#endif // DEBUG
 
 // ---------------------------------------------------------------------------
-// Emulate one instruction
+// Opcode handlers
 // ---------------------------------------------------------------------------
-void Chip8::emulate_instruction(const Config &config) {
-    // Fetch
-    inst_.opcode = static_cast<uint16_t>((ram_[PC_] << 8) | ram_[PC_ + 1]);
-    PC_ += 2;
+// Each handler executes one pre-decoded instruction. PC_ has already been
+// advanced past the instruction when a handler runs.
+//
+// Handlers whose behaviour depends on the dialect are templates over just
+// the bits they read (Xo: XO-CHIP, or a single quirk), and decode() picks
+// the instantiation. Ops an extension lacks decode to op_nop. Nothing in
+// the hot path looks at the config's extension or quirks.
+struct Chip8::Ops {
+    // Skips the next instruction, which on XO-CHIP may be the 4-byte F000 NNNN
+    template <bool Xo>
+    static void skip(Chip8 &c) {
+        c.PC_ += (Xo && c.fetch(c.PC_) == 0xF000) ? 4 : 2;
+    }
+
+    // Bitplanes drawing and scrolling act on: always plane 0 before XO-CHIP
+    template <bool Xo>
+    static unsigned plane_mask(const Chip8 &c) { return Xo ? c.planes_ : 1u; }
 
-    // Decode
-    inst_.NNN = inst_.opcode & 0x0FFF;
-    inst_.NN  = inst_.opcode & 0x00FF;
-    inst_.N   = inst_.opcode & 0x000F;
-    inst_.X   = (inst_.opcode >> 8) & 0x0F;
-    inst_.Y   = (inst_.opcode >> 4) & 0x0F;
+    static void op_nop(Chip8 &, const DecodedInst &, const Config &) {
+        // Unimplemented / invalid opcode
+    }
 
-#ifdef DEBUG
-    print_debug_info();
-#endif
+    template <bool Xo>
+    static void op_00E0(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00E0: Clear screen (XO-CHIP: the selected planes)
+        c.display_.clear_planes(plane_mask<Xo>(c));
+        c.draw_ = true;
+    }
 
-    // Execute
-    switch ((inst_.opcode >> 12) & 0x0F) {
+    // SUPER-CHIP display ops. Plain CHIP-8 treats 0NNN as a machine-code
+    // call, which is ignored.
+    template <bool Xo>
+    static void op_00CN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 00CN: Scroll down N rows
+        c.display_.scroll_down(d.N, plane_mask<Xo>(c));
+        c.draw_ = true;
+    }
 
-        case 0x00:
-            if (inst_.NN == 0xE0) {
-                // 00E0: Clear screen
-                display_.fill(false);
-                draw_ = true;
-            } else if (inst_.NN == 0xEE) {
-                // 00EE: Return from subroutine
-                assert(sp_ > 0 && "Stack underflow");
-                PC_ = stack_[--sp_];
+    static void op_00DN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 00DN: Scroll up N rows (XO-CHIP)
+        c.display_.scroll_up(d.N, c.planes_);
+        c.draw_ = true;
+    }
+
+    template <bool Xo>
+    static void op_00FB(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00FB: Scroll right 4 pixels
+        c.display_.scroll_right(4, plane_mask<Xo>(c));
+        c.draw_ = true;
+    }
+
+    template <bool Xo>
+    static void op_00FC(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00FC: Scroll left 4 pixels
+        c.display_.scroll_left(4, plane_mask<Xo>(c));
+        c.draw_ = true;
+    }
+
+    static void op_00FD(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00FD: Exit the interpreter; PC stays on this instruction
+        c.PC_ -= 2;
+        c.state_ = EmulatorState::QUIT;
+    }
+
+    static void op_00FE(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00FE: Low resolution (64x32); the screen is cleared
+        c.display_.resize(LORES_W, LORES_H);
+        c.draw_ = true;
+    }
+
+    static void op_00FF(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00FF: High resolution (128x64); the screen is cleared
+        c.display_.resize(HIRES_W, HIRES_H);
+        c.draw_ = true;
+    }
+
+    static void op_00EE(Chip8 &c, const DecodedInst &, const Config &) {
+        // 00EE: Return from subroutine
+        assert(c.sp_ > 0 && "Stack underflow");
+        c.PC_ = c.stack_[--c.sp_];
+    }
+
+    static void op_1NNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 1NNN: Jump
+        c.PC_ = d.NNN;
+    }
+
+    static void op_2NNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 2NNN: Call subroutine
+        assert(c.sp_ < STACK_SIZE && "Stack overflow");
+        c.stack_[c.sp_++] = c.PC_;
+        c.PC_             = d.NNN;
+    }
+
+    template <bool Xo>
+    static void op_3XNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 3XNN: Skip if VX == NN
+        if (c.V_[d.X] == d.NN) skip<Xo>(c);
+    }
+
+    template <bool Xo>
+    static void op_4XNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 4XNN: Skip if VX != NN
+        if (c.V_[d.X] != d.NN) skip<Xo>(c);
+    }
+
+    template <bool Xo>
+    static void op_5XY0(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 5XY0: Skip if VX == VY
+        if (c.V_[d.X] == c.V_[d.Y]) skip<Xo>(c);
+    }
+
+    static void op_5XY2(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 5XY2: Store VX..VY (in that order, either direction) at I; I unchanged
+        const int dir  = d.X <= d.Y ? 1 : -1;
+        const int span = d.X <= d.Y ? d.Y - d.X : d.X - d.Y;
+        for (int i = 0; i <= span; ++i) c.write_ram(static_cast<uint16_t>(c.I_ + i), c.V_[d.X + i * dir]);
+    }
+
+    static void op_5XY3(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 5XY3: Load VX..VY from I; I unchanged
+        const int dir  = d.X <= d.Y ? 1 : -1;
+        const int span = d.X <= d.Y ? d.Y - d.X : d.X - d.Y;
+        for (int i = 0; i <= span; ++i) c.V_[d.X + i * dir] = c.ram_[static_cast<uint16_t>(c.I_ + i)];
+    }
+
+    static void op_6XNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 6XNN: VX = NN
+        c.V_[d.X] = d.NN;
+    }
+
+    static void op_7XNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 7XNN: VX += NN (no carry flag)
+        c.V_[d.X] += d.NN;
+    }
+
+    static void op_8XY0(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY0: VX = VY
+        c.V_[d.X] = c.V_[d.Y];
+    }
+
+    template <bool VfReset>
+    static void op_8XY1(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY1: VX |= VY
+        c.V_[d.X] |= c.V_[d.Y];
+        if (VfReset) c.V_[0xF] = 0;
+    }
+
+    template <bool VfReset>
+    static void op_8XY2(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY2: VX &= VY
+        c.V_[d.X] &= c.V_[d.Y];
+        if (VfReset) c.V_[0xF] = 0;
+    }
+
+    template <bool VfReset>
+    static void op_8XY3(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY3: VX ^= VY
+        c.V_[d.X] ^= c.V_[d.Y];
+        if (VfReset) c.V_[0xF] = 0;
+    }
+
+    static void op_8XY4(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY4: VX += VY, VF = carry
+        const uint16_t sum = static_cast<uint16_t>(c.V_[d.X]) + c.V_[d.Y];
+        c.V_[d.X]          = static_cast<uint8_t>(sum);
+        c.V_[0xF]          = (sum > 0xFF) ? 1 : 0;
+    }
+
+    static void op_8XY5(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY5: VX -= VY, VF = !borrow
+        const uint8_t vx = c.V_[d.X];
+        const uint8_t vy = c.V_[d.Y];
+        c.V_[d.X]        = vx - vy;
+        c.V_[0xF]        = (vx >= vy) ? 1 : 0;
+    }
+
+    template <bool ShiftVy>
+    static void op_8XY6(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY6: VX = VY >> 1 (shift quirk off, as on SCHIP: VX >>= 1)
+        if (ShiftVy) {
+            c.V_[0xF] = c.V_[d.Y] & 0x01;
+            c.V_[d.X] = c.V_[d.Y] >> 1;
+        } else {
+            c.V_[0xF] = c.V_[d.X] & 0x01;
+            c.V_[d.X] >>= 1;
+        }
+    }
+
+    static void op_8XY7(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XY7: VX = VY - VX, VF = !borrow
+        const uint8_t vx = c.V_[d.X];
+        const uint8_t vy = c.V_[d.Y];
+        c.V_[d.X]        = vy - vx;
+        c.V_[0xF]        = (vy >= vx) ? 1 : 0;
+    }
+
+    template <bool ShiftVy>
+    static void op_8XYE(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 8XYE: VX = VY << 1 (shift quirk off, as on SCHIP: VX <<= 1)
+        if (ShiftVy) {
+            c.V_[0xF] = (c.V_[d.Y] & 0x80) >> 7;
+            c.V_[d.X] = c.V_[d.Y] << 1;
+        } else {
+            c.V_[0xF] = (c.V_[d.X] & 0x80) >> 7;
+            c.V_[d.X] <<= 1;
+        }
+    }
+
+    template <bool Xo>
+    static void op_9XY0(Chip8 &c, const DecodedInst &d, const Config &) {
+        // 9XY0: Skip if VX != VY
+        if (c.V_[d.X] != c.V_[d.Y]) skip<Xo>(c);
+    }
+
+    static void op_ANNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // ANNN: I = NNN
+        c.I_ = d.NNN;
+    }
+
+    template <bool JumpVx>
+    static void op_BNNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // BNNN: PC = NNN + V0 (jump quirk, as on SCHIP: BXNN, PC = XNN + VX)
+        const uint8_t offset = JumpVx ? c.V_[d.X] : c.V_[0];
+        c.PC_                = d.NNN + offset;
+    }
+
+    static void op_CXNN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // CXNN: VX = rand() & NN
+        c.V_[d.X] = static_cast<uint8_t>(c.rand_byte_(c.rng_)) & d.NN;
+    }
+
+    // DXYN: Draw N-row sprite at (VX, VY). Sprites clip at the right and
+    // bottom edges, or wrap around both with the wrap quirk. SCHIP DXY0:
+    // 16x16 sprite, two bytes per row. On XO-CHIP each selected plane gets
+    // its own sprite, stored one after the other from I, and all planes are
+    // drawn in a single pass over the rows.
+    template <Extension E, bool Wrap>
+    static void op_DXYN(Chip8 &c, const DecodedInst &d, const Config &) {
+        // Screen sizes are powers of two, so start coordinates wrap with a mask
+        const std::size_t width   = c.display_.width();
+        const std::size_t height  = c.display_.height();
+        const std::size_t x_start = c.V_[d.X] & (width - 1);
+        const std::size_t y_start = c.V_[d.Y] & (height - 1);
+        const bool wide           = d.N == 0 && E != Extension::CHIP8;
+        const uint8_t rows        = wide ? 16 : d.N;
+        const std::size_t wrap_at = width - x_start; // sprite column that lands on x = 0
+
+        unsigned planes[FrameBuffer::PLANES] = { 0 };
+        std::size_t nplanes                  = 1;
+        if (E == Extension::XOCHIP) {
+            nplanes = 0;
+            for (unsigned p = 0; p < FrameBuffer::PLANES; ++p)
+                if ((c.planes_ >> p) & 1) planes[nplanes++] = p;
+        }
+
+        // Rows from y_start to the bottom edge, then the rest either
+        // clipped or wrapped to the top
+        const std::size_t upper = rows < height - y_start ? rows : height - y_start;
+        const std::size_t lower = Wrap ? rows - upper : 0;
+
+        bool hit = false;
+        if (nplanes) {
+            const uint64_t *bits = c.sprite_rows(c.I_, static_cast<unsigned>(nplanes * rows), wide ? 2 : 1);
+            for (std::size_t i = 0; i < nplanes; ++i, bits += rows) {
+                hit |= c.display_.xor_rows(x_start, y_start, bits, upper, planes[i]);
+                hit |= c.display_.xor_rows(x_start, 0, bits + upper, lower, planes[i]);
+                if (Wrap && wrap_at < 16) {
+                    const unsigned skip = static_cast<unsigned>(wrap_at);
+                    hit |= c.display_.xor_rows(0, y_start, bits, upper, planes[i], skip);
+                    hit |= c.display_.xor_rows(0, 0, bits + upper, lower, planes[i], skip);
+                }
             }
-            break;
+        }
+        c.V_[0xF] = hit;
+        c.draw_   = true;
 
-        case 0x01:
-            // 1NNN: Jump
-            PC_ = inst_.NNN;
-            break;
+        c.perf_.draws++;
+        c.perf_.sprite_rows += nplanes ? upper + lower : 0;
+        c.perf_.collisions += hit;
+    }
 
-        case 0x02:
-            // 2NNN: Call subroutine
-            assert(sp_ < STACK_SIZE && "Stack overflow");
-            stack_[sp_++] = PC_;
-            PC_           = inst_.NNN;
-            break;
+    template <bool Xo>
+    static void op_EX9E(Chip8 &c, const DecodedInst &d, const Config &) {
+        // EX9E: Skip if key VX pressed
+        if (c.keypad_[c.V_[d.X] & 0x0F]) skip<Xo>(c);
+    }
 
-        case 0x03:
-            // 3XNN: Skip if VX == NN
-            if (V_[inst_.X] == inst_.NN) PC_ += 2;
-            break;
+    template <bool Xo>
+    static void op_EXA1(Chip8 &c, const DecodedInst &d, const Config &) {
+        // EXA1: Skip if key VX not pressed
+        if (!c.keypad_[c.V_[d.X] & 0x0F]) skip<Xo>(c);
+    }
 
-        case 0x04:
-            // 4XNN: Skip if VX != NN
-            if (V_[inst_.X] != inst_.NN) PC_ += 2;
-            break;
+    static void op_F000(Chip8 &c, const DecodedInst &, const Config &) {
+        // F000 NNNN: I = NNNN, the following word (XO-CHIP)
+        c.I_ = c.fetch(c.PC_);
+        c.PC_ += 2;
+    }
 
-        case 0x05:
-            // 5XY0: Skip if VX == VY
-            if (inst_.N != 0) break; // invalid sub-opcode
-            if (V_[inst_.X] == V_[inst_.Y]) PC_ += 2;
-            break;
+    static void op_FN01(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FN01: Select the bitplanes (bit 0: plane 1, bit 1: plane 2) to draw on
+        c.planes_ = d.X & FrameBuffer::ALL_PLANES;
+    }
 
-        case 0x06:
-            // 6XNN: VX = NN
-            V_[inst_.X] = inst_.NN;
-            break;
+    static void op_F002(Chip8 &c, const DecodedInst &, const Config &) {
+        // F002: Load the 16-byte audio pattern from I
+        for (uint16_t i = 0; i < 16; ++i) c.audio_pattern_[i] = c.ram_[static_cast<uint16_t>(c.I_ + i)];
+        c.audio_pattern_set_ = true;
+    }
 
-        case 0x07:
-            // 7XNN: VX += NN (no carry flag)
-            V_[inst_.X] += inst_.NN;
-            break;
+    static void op_FX07(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX07: VX = delay_timer
+        c.V_[d.X] = c.delay_timer_;
+    }
+
+    static void op_FX0A(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX0A: Wait for key press, store in VX
+        // State is tracked in members, not statics
+        if (!c.fx0a_waiting_) {
+            // Phase 1: scan for any key currently pressed
+            for (uint8_t i = 0; i < static_cast<uint8_t>(c.keypad_.size()); ++i) {
+                if (c.keypad_[i]) {
+                    c.fx0a_key_     = i;
+                    c.fx0a_waiting_ = true;
+                    break;
+                }
+            }
+            if (!c.fx0a_waiting_) {
+                c.PC_ -= 2; // re-execute this instruction next cycle
+            }
+        } else {
+            // Phase 2: wait for key to be released
+            if (c.keypad_[c.fx0a_key_]) {
+                c.PC_ -= 2; // still held, keep waiting
+            } else {
+                c.V_[d.X]       = c.fx0a_key_;
+                c.fx0a_waiting_ = false;
+                c.fx0a_key_     = 0xFF;
+            }
+        }
+    }
+
+    static void op_FX15(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX15: delay_timer = VX
+        c.delay_timer_ = c.V_[d.X];
+    }
+
+    static void op_FX18(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX18: sound_timer = VX
+        c.sound_timer_ = c.V_[d.X];
+    }
+
+    static void op_FX1E(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX1E: I += VX
+        c.I_ += c.V_[d.X];
+    }
+
+    static void op_FX29(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX29: I = sprite address for digit VX
+        c.I_ = c.V_[d.X] * 5;
+    }
+
+    static void op_FX30(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX30: I = large (8x10) sprite address for digit VX
+        c.I_ = static_cast<uint16_t>(BIG_FONT_START + (c.V_[d.X] & 0x0F) * 10);
+    }
+
+    static void op_FX3A(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX3A: Audio pattern pitch = VX
+        c.pitch_ = c.V_[d.X];
+    }
 
-        case 0x08: {
-            const bool is_chip8 = (config.current_extension == Extension::CHIP8);
-            switch (inst_.N) {
-                case 0x0:
-                    // 8XY0: VX = VY
-                    V_[inst_.X] = V_[inst_.Y];
+    static void op_FX33(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX33: Store BCD of VX at I, I+1, I+2
+        uint8_t bcd = c.V_[d.X];
+        c.write_ram(c.I_ + 2, bcd % 10);
+        bcd /= 10;
+        c.write_ram(c.I_ + 1, bcd % 10);
+        bcd /= 10;
+        c.write_ram(c.I_, bcd);
+    }
+
+    template <bool MemoryI>
+    static void op_FX55(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX55: Dump V0–VX to memory at I (I advances with the memory quirk)
+        for (uint8_t i = 0; i <= d.X; ++i) {
+            if (MemoryI)
+                c.write_ram(c.I_++, c.V_[i]);
+            else
+                c.write_ram(c.I_ + i, c.V_[i]);
+        }
+    }
+
+    template <bool MemoryI>
+    static void op_FX65(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX65: Load V0–VX from memory at I (I advances with the memory quirk)
+        for (uint8_t i = 0; i <= d.X; ++i) {
+            if (MemoryI)
+                c.V_[i] = c.ram_[c.I_++ & (RAM_SIZE - 1)];
+            else
+                c.V_[i] = c.ram_[(c.I_ + i) & (RAM_SIZE - 1)];
+        }
+    }
+
+    static void op_FX75(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX75: Save V0–VX to the RPL user flags
+        std::copy(c.V_.begin(), c.V_.begin() + d.X + 1, c.rpl_.begin());
+    }
+
+    static void op_FX85(Chip8 &c, const DecodedInst &d, const Config &) {
+        // FX85: Load V0–VX from the RPL user flags
+        std::copy(c.rpl_.begin(), c.rpl_.begin() + d.X + 1, c.V_.begin());
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Decode
+// ---------------------------------------------------------------------------
+// Resolves an opcode to its handler and operands once; the result is cached
+// per program address so the hot loop skips fetch, field extraction and the
+// nested switch entirely. The handler is the one specialised for `dialect`.
+DecodedInst Chip8::decode(uint16_t opcode, const Dialect &dialect) {
+    DecodedInst d;
+    d.opcode = opcode;
+    d.NNN    = opcode & 0x0FFF;
+    d.NN     = opcode & 0x00FF;
+    d.N      = opcode & 0x000F;
+    d.X      = (opcode >> 8) & 0x0F;
+    d.Y      = (opcode >> 4) & 0x0F;
+    d.fn     = &Ops::op_nop;
+
+    const bool schip    = dialect.extension != Extension::CHIP8; // SUPER-CHIP ops, also part of XO-CHIP
+    const bool xo       = dialect.extension == Extension::XOCHIP;
+    const bool vf_reset = dialect.quirks & QUIRK_VF_RESET;
+    const bool shift_vy = dialect.quirks & QUIRK_SHIFT_VY;
+    const bool memory_i = dialect.quirks & QUIRK_MEMORY_I;
+    const bool wrap     = dialect.quirks & QUIRK_WRAP;
+    const bool jump_vx  = dialect.quirks & QUIRK_JUMP_VX;
+
+    switch ((opcode >> 12) & 0x0F) {
+        case 0x00:
+            if (d.Y == 0xC && d.X == 0) {
+                if (schip) d.fn = xo ? &Ops::op_00CN<true> : &Ops::op_00CN<false>;
+            } else if (d.Y == 0xD && d.X == 0) {
+                if (xo) d.fn = &Ops::op_00DN;
+            } else if (d.NN == 0xE0 || d.NNN == 0x230) { // 0230: VIP hires clear
+                d.fn = xo ? &Ops::op_00E0<true> : &Ops::op_00E0<false>;
+            } else if (d.NN == 0xEE) {
+                d.fn = &Ops::op_00EE;
+            } else if (!schip) {
+                break;
+            } else if (d.NNN == 0x0FB) {
+                d.fn = xo ? &Ops::op_00FB<true> : &Ops::op_00FB<false>;
+            } else if (d.NNN == 0x0FC) {
+                d.fn = xo ? &Ops::op_00FC<true> : &Ops::op_00FC<false>;
+            } else if (d.NNN == 0x0FD) {
+                d.fn = &Ops::op_00FD;
+            } else if (d.NNN == 0x0FE) {
+                d.fn = &Ops::op_00FE;
+            } else if (d.NNN == 0x0FF) {
+                d.fn = &Ops::op_00FF;
+            }
+            break;
+        case 0x01: d.fn = &Ops::op_1NNN; break;
+        case 0x02: d.fn = &Ops::op_2NNN; break;
+        case 0x03: d.fn = xo ? &Ops::op_3XNN<true> : &Ops::op_3XNN<false>; break;
+        case 0x04: d.fn = xo ? &Ops::op_4XNN<true> : &Ops::op_4XNN<false>; break;
+        case 0x05:
+            if (d.N == 0) d.fn = xo ? &Ops::op_5XY0<true> : &Ops::op_5XY0<false>;
+            else if (d.N == 2 && xo) d.fn = &Ops::op_5XY2;
+            else if (d.N == 3 && xo) d.fn = &Ops::op_5XY3;
+            break;
+        case 0x06: d.fn = &Ops::op_6XNN; break;
+        case 0x07: d.fn = &Ops::op_7XNN; break;
+        case 0x08:
+            switch (d.N) {
+                case 0x0: d.fn = &Ops::op_8XY0; break;
+                case 0x1: d.fn = vf_reset ? &Ops::op_8XY1<true> : &Ops::op_8XY1<false>; break;
+                case 0x2: d.fn = vf_reset ? &Ops::op_8XY2<true> : &Ops::op_8XY2<false>; break;
+                case 0x3: d.fn = vf_reset ? &Ops::op_8XY3<true> : &Ops::op_8XY3<false>; break;
+                case 0x4: d.fn = &Ops::op_8XY4; break;
+                case 0x5: d.fn = &Ops::op_8XY5; break;
+                case 0x6: d.fn = shift_vy ? &Ops::op_8XY6<true> : &Ops::op_8XY6<false>; break;
+                case 0x7: d.fn = &Ops::op_8XY7; break;
+                case 0xE: d.fn = shift_vy ? &Ops::op_8XYE<true> : &Ops::op_8XYE<false>; break;
+                default: break;
+            }
+            break;
+        case 0x09: d.fn = xo ? &Ops::op_9XY0<true> : &Ops::op_9XY0<false>; break;
+        case 0x0A: d.fn = &Ops::op_ANNN; break;
+        case 0x0B: d.fn = jump_vx ? &Ops::op_BNNN<true> : &Ops::op_BNNN<false>; break;
+        case 0x0C: d.fn = &Ops::op_CXNN; break;
+        case 0x0D:
+            switch (dialect.extension) {
+                case Extension::CHIP8:
+                    d.fn = wrap ? &Ops::op_DXYN<Extension::CHIP8, true> : &Ops::op_DXYN<Extension::CHIP8, false>;
                     break;
-                case 0x1:
-                    // 8XY1: VX |= VY
-                    V_[inst_.X] |= V_[inst_.Y];
-                    if (is_chip8) V_[0xF] = 0;
+                case Extension::SUPERCHIP:
+                    d.fn = wrap ? &Ops::op_DXYN<Extension::SUPERCHIP, true>
+                                : &Ops::op_DXYN<Extension::SUPERCHIP, false>;
                     break;
-                case 0x2:
-                    // 8XY2: VX &= VY
-                    V_[inst_.X] &= V_[inst_.Y];
-                    if (is_chip8) V_[0xF] = 0;
+                case Extension::XOCHIP:
+                    d.fn = wrap ? &Ops::op_DXYN<Extension::XOCHIP, true> : &Ops::op_DXYN<Extension::XOCHIP, false>;
                     break;
-                case 0x3:
-                    // 8XY3: VX ^= VY
-                    V_[inst_.X] ^= V_[inst_.Y];
-                    if (is_chip8) V_[0xF] = 0;
+            }
+            break;
+        case 0x0E:
+            if (d.NN == 0x9E) d.fn = xo ? &Ops::op_EX9E<true> : &Ops::op_EX9E<false>;
+            else if (d.NN == 0xA1) d.fn = xo ? &Ops::op_EXA1<true> : &Ops::op_EXA1<false>;
+            break;
+        case 0x0F:
+            switch (d.NN) {
+                case 0x00:
+                    if (d.X == 0 && xo) d.fn = &Ops::op_F000;
                     break;
-                case 0x4: {
-                    // 8XY4: VX += VY, VF = carry
-                    const uint16_t sum = static_cast<uint16_t>(V_[inst_.X]) + V_[inst_.Y];
-                    V_[inst_.X]        = static_cast<uint8_t>(sum);
-                    V_[0xF]            = (sum > 0xFF) ? 1 : 0;
+                case 0x01:
+                    if (xo) d.fn = &Ops::op_FN01;
                     break;
-                }
-                case 0x5: {
-                    // 8XY5: VX -= VY, VF = !borrow
-                    const uint8_t vx = V_[inst_.X];
-                    const uint8_t vy = V_[inst_.Y];
-                    V_[inst_.X]      = vx - vy;
-                    V_[0xF]          = (vx >= vy) ? 1 : 0;
+                case 0x02:
+                    if (d.X == 0 && xo) d.fn = &Ops::op_F002;
                     break;
-                }
-                case 0x6:
-                    // 8XY6: VX >>= 1 (CHIP8: use VY; SCHIP: use VX)
-                    if (is_chip8) {
-                        V_[0xF]     = V_[inst_.Y] & 0x01;
-                        V_[inst_.X] = V_[inst_.Y] >> 1;
-                    } else {
-                        V_[0xF] = V_[inst_.X] & 0x01;
-                        V_[inst_.X] >>= 1;
-                    }
+                case 0x07: d.fn = &Ops::op_FX07; break;
+                case 0x0A: d.fn = &Ops::op_FX0A; break;
+                case 0x15: d.fn = &Ops::op_FX15; break;
+                case 0x18: d.fn = &Ops::op_FX18; break;
+                case 0x1E: d.fn = &Ops::op_FX1E; break;
+                case 0x29: d.fn = &Ops::op_FX29; break;
+                case 0x30:
+                    if (schip) d.fn = &Ops::op_FX30;
                     break;
-                case 0x7: {
-                    // 8XY7: VX = VY - VX, VF = !borrow
-                    const uint8_t vx = V_[inst_.X];
-                    const uint8_t vy = V_[inst_.Y];
-                    V_[inst_.X]      = vy - vx;
-                    V_[0xF]          = (vy >= vx) ? 1 : 0;
+                case 0x33: d.fn = &Ops::op_FX33; break;
+                case 0x3A:
+                    if (xo) d.fn = &Ops::op_FX3A;
                     break;
-                }
-                case 0xE:
-                    // 8XYE: VX <<= 1 (CHIP8: use VY; SCHIP: use VX)
-                    if (is_chip8) {
-                        V_[0xF]     = (V_[inst_.Y] & 0x80) >> 7;
-                        V_[inst_.X] = V_[inst_.Y] << 1;
-                    } else {
-                        V_[0xF] = (V_[inst_.X] & 0x80) >> 7;
-                        V_[inst_.X] <<= 1;
-                    }
+                case 0x55: d.fn = memory_i ? &Ops::op_FX55<true> : &Ops::op_FX55<false>; break;
+                case 0x65: d.fn = memory_i ? &Ops::op_FX65<true> : &Ops::op_FX65<false>; break;
+                case 0x75:
+                    if (schip) d.fn = &Ops::op_FX75;
                     break;
-                default:
+                case 0x85:
+                    if (schip) d.fn = &Ops::op_FX85;
                     break;
+                default: break;
             }
             break;
-        }
-
-        case 0x09:
-            // 9XY0: Skip if VX != VY
-            if (V_[inst_.X] != V_[inst_.Y]) PC_ += 2;
-            break;
-
-        case 0x0A:
-            // ANNN: I = NNN
-            I_ = inst_.NNN;
-            break;
-
-        case 0x0B:
-            // BNNN: PC = NNN + V0
-            PC_ = inst_.NNN + V_[0];
+        default:
             break;
+    }
+    return d;
+}
 
-        case 0x0C:
-            // CXNN: VX = rand() & NN
-            V_[inst_.X] = static_cast<uint8_t>(rand_byte_(rng_)) & inst_.NN;
-            break;
+uint16_t Chip8::fetch(uint16_t addr) const {
+    return static_cast<uint16_t>((ram_[addr & (RAM_SIZE - 1)] << 8) | ram_[(addr + 1) & (RAM_SIZE - 1)]);
+}
 
-        case 0x0D: {
-            // DXYN: Draw N-row sprite at (VX, VY)
-            const uint8_t x_start = V_[inst_.X] % static_cast<uint8_t>(config.window_width);
-            const uint8_t y_start = V_[inst_.Y] % static_cast<uint8_t>(config.window_height);
-            V_[0xF]               = 0;
+// Writes made by the CPU go through here so decoded instructions covering
+// the address (an instruction starting at addr or at addr - 1) and cached
+// sprites reading it are dropped.
+void Chip8::write_ram(uint16_t addr, uint8_t value) {
+    addr &= RAM_SIZE - 1;
+    ram_[addr] = value;
+    if (sprite_cover_[addr]) flush_sprites();
 
-            for (uint8_t row = 0; row < inst_.N; ++row) {
-                const uint8_t sprite_byte = ram_[I_ + row];
-                const uint8_t y           = y_start + row;
-                if (y >= config.window_height) break;
+    if (addr < ROM_START) return;
+    decode_cache_[addr - ROM_START].fn = nullptr;
+    if (addr > ROM_START) decode_cache_[addr - ROM_START - 1].fn = nullptr;
 
-                for (int8_t col = 7; col >= 0; --col) {
-                    const uint8_t x = x_start + static_cast<uint8_t>(7 - col);
-                    if (x >= config.window_width) break;
+    // Block ops may be executing right now, so only flag the flush here
+    if (block_cover_[addr - ROM_START]) blocks_dirty_ = true;
+}
 
-                    const bool sprite_bit = (sprite_byte >> col) & 0x01;
-                    bool &pixel           = display_[y * config.window_width + x];
+// DXYN's sprite at `addr`: `count` rows of `row_bytes` bytes, as
+// left-aligned masks. Read from RAM on a miss and kept until a write to one
+// of its bytes.
+const uint64_t *Chip8::sprite_rows(uint16_t addr, unsigned count, unsigned row_bytes) {
+    Sprite &s            = sprites_[(addr * 0x9E3779B1u) >> 27];
+    const unsigned bytes = count * row_bytes;
+    if (s.addr == addr && s.bytes == bytes && s.row_bytes == row_bytes) return s.rows.data();
+
+    s.addr      = addr;
+    s.bytes     = static_cast<uint16_t>(bytes);
+    s.row_bytes = static_cast<uint8_t>(row_bytes);
+    for (unsigned r = 0; r < count; ++r) {
+        const uint16_t src = static_cast<uint16_t>(addr + r * row_bytes);
+        uint64_t bits      = static_cast<uint64_t>(ram_[src]) << 56;
+        if (row_bytes == 2) bits |= static_cast<uint64_t>(ram_[static_cast<uint16_t>(src + 1)]) << 48;
+        s.rows[r] = bits;
+    }
 
-                    if (sprite_bit && pixel) V_[0xF] = 1;
-                    pixel ^= sprite_bit;
-                }
-            }
-            draw_ = true;
-            break;
-        }
+    for (unsigned b = 0; b < bytes; ++b) sprite_cover_[static_cast<uint16_t>(addr + b)] = 1;
+    if (addr + bytes > RAM_SIZE) { // runs past the top of RAM to address 0
+        sprite_cover_lo_ = 0;
+        sprite_cover_hi_ = RAM_SIZE;
+    } else {
+        sprite_cover_lo_ = std::min<std::size_t>(sprite_cover_lo_, addr);
+        sprite_cover_hi_ = std::max<std::size_t>(sprite_cover_hi_, addr + bytes);
+    }
+    return s.rows.data();
+}
 
-        case 0x0E:
-            if (inst_.NN == 0x9E) {
-                // EX9E: Skip if key VX pressed
-                if (keypad_[V_[inst_.X]]) PC_ += 2;
-            } else if (inst_.NN == 0xA1) {
-                // EXA1: Skip if key VX not pressed
-                if (!keypad_[V_[inst_.X]]) PC_ += 2;
-            }
-            break;
+// Evicted sprites may still have bytes marked; they are cleared here too
+void Chip8::flush_sprites() {
+    for (Sprite &s : sprites_) s.bytes = 0;
+    if (sprite_cover_lo_ < sprite_cover_hi_)
+        std::fill(sprite_cover_.begin() + static_cast<std::ptrdiff_t>(sprite_cover_lo_),
+                  sprite_cover_.begin() + static_cast<std::ptrdiff_t>(sprite_cover_hi_), uint8_t{ 0 });
+    sprite_cover_lo_ = RAM_SIZE;
+    sprite_cover_hi_ = 0;
+}
 
-        case 0x0F:
-            switch (inst_.NN) {
+void Chip8::flush_decode_cache() {
+    for (DecodedInst &d : decode_cache_) d.fn = nullptr;
+}
 
-                case 0x07:
-                    // FX07: VX = delay_timer
-                    V_[inst_.X] = delay_timer_;
-                    break;
+// Everything decoded so far has another dialect's handlers baked in
+void Chip8::set_dialect(const Dialect &dialect) {
+    const bool decoded = dialect_.quirks != NO_DIALECT;
+    dialect_           = dialect;
+    if (!decoded) return;
+    flush_decode_cache();
+    flush_blocks();
+}
 
-                case 0x0A: {
-                    // FX0A: Wait for key press, store in VX
-                    // State is tracked in members, not statics
-                    if (!fx0a_waiting_) {
-                        // Phase 1: scan for any key currently pressed
-                        for (uint8_t i = 0; i < static_cast<uint8_t>(keypad_.size()); ++i) {
-                            if (keypad_[i]) {
-                                fx0a_key_     = i;
-                                fx0a_waiting_ = true;
-                                break;
-                            }
-                        }
-                        if (!fx0a_waiting_) {
-                            PC_ -= 2; // re-execute this instruction next cycle
-                        }
-                    } else {
-                        // Phase 2: wait for key to be released
-                        if (keypad_[fx0a_key_]) {
-                            PC_ -= 2; // still held, keep waiting
-                        } else {
-                            V_[inst_.X]   = fx0a_key_;
-                            fx0a_waiting_ = false;
-                            fx0a_key_     = 0xFF;
-                        }
-                    }
-                    break;
-                }
+// ---------------------------------------------------------------------------
+// Emulate one instruction
+// ---------------------------------------------------------------------------
+inline void Chip8::step(const Config &config) {
+    const uint16_t pc = PC_;
+    PC_ += 2;
 
-                case 0x15:
-                    // FX15: delay_timer = VX
-                    delay_timer_ = V_[inst_.X];
-                    break;
+    if (pc >= ROM_START && pc < RAM_SIZE - 1) {
+        // Program region: decode on first visit, then dispatch from the cache.
+        // Handlers only ever clear .fn on invalidation, so `d` stays readable
+        // even if the instruction overwrites itself.
+        DecodedInst &d = decode_cache_[pc - ROM_START];
+        if (!d.fn) d = decode(fetch(pc), dialect_);
+        perf_.op_class[d.opcode >> 12]++;
+        d.fn(*this, d, config);
+    } else {
+        const DecodedInst d = decode(fetch(pc), dialect_);
+        perf_.op_class[d.opcode >> 12]++;
+        d.fn(*this, d, config);
+    }
+}
 
-                case 0x18:
-                    // FX18: sound_timer = VX
-                    sound_timer_ = V_[inst_.X];
-                    break;
+void Chip8::emulate_instruction(const Config &config) {
+    if (const Dialect target = dialect(config); target != dialect_) set_dialect(target);
+    step(config);
+}
 
-                case 0x1E:
-                    // FX1E: I += VX
-                    I_ += V_[inst_.X];
-                    break;
+void Chip8::execute(const Config &config) {
+    step(config);
+}
 
-                case 0x29:
-                    // FX29: I = sprite address for digit VX
-                    I_ = V_[inst_.X] * 5;
-                    break;
+void Chip8::run(const Config &config, uint32_t count) {
+    if (const Dialect target = dialect(config); target != dialect_) set_dialect(target);
+    if (tracer_ || !config.profile_path.empty()) {
+        run_instrumented(config, count);
+        return;
+    }
 
-                case 0x33: {
-                    // FX33: Store BCD of VX at I, I+1, I+2
-                    uint8_t bcd  = V_[inst_.X];
-                    ram_[I_ + 2] = bcd % 10;
-                    bcd /= 10;
-                    ram_[I_ + 1] = bcd % 10;
-                    bcd /= 10;
-                    ram_[I_] = bcd;
-                    break;
-                }
+    // A jump back (or an op re-executing itself) may have entered an idle
+    // loop; skip_idle() checks, and fast-forwards through it if so. Calls
+    // and returns move the stack pointer and are never part of one.
+    const bool idle_skip = config.idle_skip;
+
+    if (config.engine == Engine::BLOCK || config.engine == Engine::JIT) {
+        while (count > 0) {
+            const uint16_t pc       = PC_;
+            const uint8_t sp        = sp_;
+            const uint32_t executed = config.engine == Engine::JIT ? run_jit(config, count)
+                                                                   : run_block(config, count);
+            if (executed > 0) {
+                count -= executed;
+            } else {
+                step(config); // PC outside the program region
+                --count;
+            }
+            if (idle_skip && PC_ <= pc && sp_ == sp && count > 0) count -= try_skip_idle(config, count);
+        }
+        return;
+    }
 
-                case 0x55:
-                    // FX55: Dump V0–VX to memory at I
-                    for (uint8_t i = 0; i <= inst_.X; ++i) {
-                        if (config.current_extension == Extension::CHIP8)
-                            ram_[I_++] = V_[i];
-                        else
-                            ram_[I_ + i] = V_[i];
-                    }
-                    break;
+    for (uint32_t i = 0; i < count;) {
+        const uint16_t pc = PC_;
+        const uint8_t sp  = sp_;
+        step(config);
+        ++i;
+        if (idle_skip && PC_ <= pc && sp_ == sp && i < count) i += try_skip_idle(config, count - i);
+    }
+}
 
-                case 0x65:
-                    // FX65: Load V0–VX from memory at I
-                    for (uint8_t i = 0; i <= inst_.X; ++i) {
-                        if (config.current_extension == Extension::CHIP8)
-                            V_[i] = ram_[I_++];
-                        else
-                            V_[i] = ram_[I_ + i];
-                    }
-                    break;
+// Profiling and tracing observe every instruction, which only the
+// interpreter visits one by one
+void Chip8::run_instrumented(const Config &config, uint32_t count) {
+    const bool profiling = !config.profile_path.empty();
+    if (profiling && pc_profile_.empty()) pc_profile_.assign(RAM_SIZE, 0);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint16_t pc = PC_;
+        if (profiling) pc_profile_[pc & (RAM_SIZE - 1)]++;
+        if (!tracer_) {
+            step(config);
+            continue;
+        }
 
-                default:
-                    break; // Unimplemented FX opcode
+        TraceRecord r;
+        r.seq    = trace_seq_++;
+        r.pc     = pc;
+        r.opcode = fetch(pc);
+        const std::array<uint8_t, 16> before = V_;
+
+        step(config);
+
+        r.I  = I_;
+        r.vf = V_[0xF];
+        r.sp = sp_;
+        for (uint8_t x = 0; x < 16; ++x) {
+            if (V_[x] != before[x]) {
+                r.reg   = x;
+                r.value = V_[x];
+                break;
             }
-            break;
-
-        default:
-            break; // Unimplemented / invalid opcode
+        }
+        tracer_->record(r);
     }
 }
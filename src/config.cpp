@@ -1,8 +1,31 @@
 #include "../include/config.hpp"
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 
+static uint8_t quirk_from_name(const std::string &name) {
+  if (name == "vf_reset") return QUIRK_VF_RESET;
+  if (name == "shift_vy") return QUIRK_SHIFT_VY;
+  if (name == "memory_i") return QUIRK_MEMORY_I;
+  if (name == "wrap") return QUIRK_WRAP;
+  if (name == "jump_vx") return QUIRK_JUMP_VX;
+  return 0;
+}
+
+bool parse_quirks(const std::string &list, uint8_t &on, uint8_t &off) {
+  std::istringstream names(list);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    const bool negated = !name.empty() && name[0] == '-';
+    const uint8_t quirk = quirk_from_name(negated ? name.substr(1) : name);
+    if (quirk == 0) return false;
+    (negated ? off : on) |= quirk;
+    (negated ? on : off) &= static_cast<uint8_t>(~quirk);
+  }
+  return true;
+}
+
 // Set up initial emulator configurations from passed in arguments
 bool set_config_from_args(Config &config, int argc, char **argv) {
 
@@ -38,6 +61,34 @@ bool set_config_from_args(Config &config, int argc, char **argv) {
       config.color_lerp_rate = std::stof(it->second);
     if (auto it = args.find("--current-extension"); it != args.end())
       config.current_extension = static_cast<Extension>(std::stoi(it->second));
+    if (auto it = args.find("--quirks"); it != args.end()) {
+      if (!parse_quirks(it->second, config.quirks_on, config.quirks_off)) {
+        std::cerr << "Error: unknown quirk in \"" << it->second << "\"\n";
+        return false;
+      }
+    }
+    if (auto it = args.find("--engine"); it != args.end())
+      config.engine = static_cast<Engine>(std::stoi(it->second));
+    if (auto it = args.find("--idle-skip"); it != args.end())
+      config.idle_skip = std::stoi(it->second) != 0;
+    if (auto it = args.find("--instructions"); it != args.end())
+      config.max_instructions = std::stoull(it->second);
+    if (auto it = args.find("--frames"); it != args.end())
+      config.max_frames = std::stoull(it->second);
+    if (auto it = args.find("--seed"); it != args.end())
+      config.seed = static_cast<int64_t>(std::stoul(it->second));
+    if (auto it = args.find("--record"); it != args.end())
+      config.record_path = it->second;
+    if (auto it = args.find("--replay"); it != args.end())
+      config.replay_path = it->second;
+    if (auto it = args.find("--profile"); it != args.end())
+      config.profile_path = it->second;
+    if (auto it = args.find("--trace"); it != args.end())
+      config.trace_path = it->second;
+    if (auto it = args.find("--run-ahead"); it != args.end())
+      config.run_ahead = static_cast<uint32_t>(std::stoul(it->second));
+    if (auto it = args.find("--rom-db"); it != args.end())
+      config.rom_db_path = it->second;
   }
 
   catch (const std::exception &e) {
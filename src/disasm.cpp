@@ -0,0 +1,110 @@
+#include "../include/disasm.hpp"
+
+#include <ios>
+
+// ---------------------------------------------------------------------------
+// Disassembly
+// ---------------------------------------------------------------------------
+void write_mnemonic(std::ostream &out, uint16_t opcode, int return_to) {
+    Instruction inst;
+    inst.opcode = opcode;
+    inst.NNN    = opcode & 0x0FFF;
+    inst.NN     = opcode & 0x00FF;
+    inst.N      = opcode & 0x000F;
+    inst.X      = (opcode >> 8) & 0x0F;
+    inst.Y      = (opcode >> 4) & 0x0F;
+
+    const auto flags = out.flags();
+    out << std::hex << std::uppercase;
+
+    switch ((inst.opcode >> 12) & 0x0F) {
+        case 0x00:
+            if (inst.NN == 0xE0)
+                out << "Clear screen";
+            else if (inst.NN == 0xEE) {
+                out << "Return from subroutine";
+                if (return_to >= 0) out << " to 0x" << return_to;
+            } else if (inst.X == 0 && inst.Y == 0xC)
+                out << "Scroll down " << +inst.N << " rows";
+            else if (inst.X == 0 && inst.Y == 0xD)
+                out << "Scroll up " << +inst.N << " rows";
+            else if (inst.NNN == 0x0FB)
+                out << "Scroll right 4 pixels";
+            else if (inst.NNN == 0x0FC)
+                out << "Scroll left 4 pixels";
+            else if (inst.NNN == 0x0FD)
+                out << "Exit";
+            else if (inst.NNN == 0x0FE)
+                out << "Low resolution";
+            else if (inst.NNN == 0x0FF)
+                out << "High resolution";
+            break;
+        case 0x01: out << "Jump to 0x" << inst.NNN; break;
+        case 0x02: out << "Call subroutine 0x" << inst.NNN; break;
+        case 0x03: out << "Skip if V" << +inst.X << " == 0x" << +inst.NN; break;
+        case 0x04: out << "Skip if V" << +inst.X << " != 0x" << +inst.NN; break;
+        case 0x05:
+            if (inst.N == 0x2) out << "Store V" << +inst.X << "-V" << +inst.Y << " to [I]";
+            else if (inst.N == 0x3) out << "Load V" << +inst.X << "-V" << +inst.Y << " from [I]";
+            else out << "Skip if V" << +inst.X << " == V" << +inst.Y;
+            break;
+        case 0x06: out << "V" << +inst.X << " = 0x" << +inst.NN; break;
+        case 0x07: out << "V" << +inst.X << " += 0x" << +inst.NN; break;
+        case 0x08:
+            switch (inst.N) {
+                case 0x0: out << "V" << +inst.X << " = V" << +inst.Y; break;
+                case 0x1: out << "V" << +inst.X << " |= V" << +inst.Y; break;
+                case 0x2: out << "V" << +inst.X << " &= V" << +inst.Y; break;
+                case 0x3: out << "V" << +inst.X << " ^= V" << +inst.Y; break;
+                case 0x4: out << "V" << +inst.X << " += V" << +inst.Y << " (carry->VF)"; break;
+                case 0x5: out << "V" << +inst.X << " -= V" << +inst.Y << " (borrow->VF)"; break;
+                case 0x6: out << "V" << +inst.X << " >>= 1 (bit->VF)"; break;
+                case 0x7: out << "V" << +inst.X << " = V" << +inst.Y << " - V" << +inst.X; break;
+                case 0xE: out << "V" << +inst.X << " <<= 1 (bit->VF)"; break;
+                default: out << "Unknown 8XYN (N=0x" << +inst.N << ")"; break;
+            }
+            break;
+        case 0x09: out << "Skip if V" << +inst.X << " != V" << +inst.Y; break;
+        case 0x0A: out << "I = 0x" << inst.NNN; break;
+        case 0x0B: out << "PC = 0x" << inst.NNN << " + V0 (SCHIP: + V" << +inst.X << ")"; break;
+        case 0x0C: out << "V" << +inst.X << " = rand & 0x" << +inst.NN; break;
+        case 0x0D:
+            if (inst.N == 0)
+                out << "Draw 16x16 at V" << +inst.X << ",V" << +inst.Y;
+            else
+                out << "Draw " << +inst.N << " rows at V" << +inst.X << ",V" << +inst.Y;
+            break;
+        case 0x0E:
+            if (inst.NN == 0x9E)
+                out << "Skip if key V" << +inst.X << " pressed";
+            else if (inst.NN == 0xA1)
+                out << "Skip if key V" << +inst.X << " not pressed";
+            break;
+        case 0x0F:
+            switch (inst.NN) {
+                case 0x00: out << "I = next word (long load)"; break;
+                case 0x01: out << "Select planes 0x" << +inst.X; break;
+                case 0x02: out << "Load audio pattern from [I]"; break;
+                case 0x07: out << "V" << +inst.X << " = delay_timer"; break;
+                case 0x0A: out << "Wait for key -> V" << +inst.X; break;
+                case 0x15: out << "delay_timer = V" << +inst.X; break;
+                case 0x18: out << "sound_timer = V" << +inst.X; break;
+                case 0x1E: out << "I += V" << +inst.X; break;
+                case 0x29: out << "I = sprite addr for V" << +inst.X; break;
+                case 0x30: out << "I = large sprite addr for V" << +inst.X; break;
+                case 0x33: out << "BCD(V" << +inst.X << ") -> [I]"; break;
+                case 0x3A: out << "Audio pitch = V" << +inst.X; break;
+                case 0x55: out << "Dump V0-V" << +inst.X << " to [I]"; break;
+                case 0x65: out << "Load V0-V" << +inst.X << " from [I]"; break;
+                case 0x75: out << "Save V0-V" << +inst.X << " to flags"; break;
+                case 0x85: out << "Load V0-V" << +inst.X << " from flags"; break;
+                default: out << "Unknown FX (NN=0x" << +inst.NN << ")"; break;
+            }
+            break;
+        default:
+            out << "Unimplemented opcode 0x" << inst.opcode;
+            break;
+    }
+
+    out.flags(flags);
+}
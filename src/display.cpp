@@ -1,8 +1,10 @@
 #include "../include/display.hpp"
+#include "../include/fade.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_rect.h>
 #include <SDL2/SDL_render.h>
 #include <SDL2/SDL_video.h>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
@@ -36,10 +38,27 @@ Display::Display(const Config &config) {
         return;
     }
 
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0"); // nearest-neighbour scaling
+    texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                 static_cast<int>(FrameBuffer::MAX_W), static_cast<int>(FrameBuffer::MAX_H));
+    if (!texture_) {
+        std::cerr << "Could not create SDL texture: " << SDL_GetError() << '\n';
+        SDL_DestroyRenderer(renderer_);
+        renderer_ = nullptr;
+        SDL_DestroyWindow(window_);
+        window_ = nullptr;
+        SDL_Quit();
+        return;
+    }
+
     pixel_color_.fill(config.bg_color);
 }
 
 Display::~Display() {
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
     if (renderer_) {
         SDL_DestroyRenderer(renderer_);
         renderer_ = nullptr;
@@ -61,62 +80,88 @@ void Display::clear_screen(const Config &config) {
     SDL_RenderClear(renderer_);
 }
 
-void Display::update_screen(const Config &config, const Chip8 &chip8) {
-    SDL_Rect rect{ 0, 0, static_cast<int>(config.scale_factor), static_cast<int>(config.scale_factor) };
+// Only rows marked dirty in `display`, plus rows still fading, are
+// re-converted to RGBA; those rows are uploaded in one texture update and the
+// whole image is scaled to the window with a single copy.
+void Display::update_screen(const Config &config, const FrameBuffer &display) {
+    if (!texture_) return;
+
+    const std::size_t width  = display.width();
+    const std::size_t height = display.height();
+    const uint64_t all_rows  = height >= 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << height) - 1;
+
+    uint64_t rows      = (display.dirty_rows() | fading_rows_) & all_rows;
+    const bool resized = width != width_ || height != height_;
+    if (resized) {
+        // Resolution change: the texel layout moved, redo everything
+        width_  = width;
+        height_ = height;
+        pixel_color_.fill(config.bg_color);
+        rows = all_rows;
+    }
+
+    // Colour per plane combination; without XO-CHIP only 0 and 1 occur
+    const uint32_t palette[4] = { config.bg_color, config.fg_color, config.plane2_color, config.plane3_color };
+    std::array<uint8_t, FrameBuffer::MAX_W> row_pixels{};
+    std::array<uint32_t, FrameBuffer::MAX_W> targets{};
+    const uint8_t weight  = fade_weight(config.color_lerp_rate);
+    std::size_t first_row = height, last_row = 0;
 
-    const auto &display = chip8.get_display();
+    for (std::size_t y = 0; y < height; ++y) {
+        if (!((rows >> y) & 1)) continue;
 
-    const uint8_t bg_r = (config.bg_color >> 24) & 0xFF;
-    const uint8_t bg_g = (config.bg_color >> 16) & 0xFF;
-    const uint8_t bg_b = (config.bg_color >> 8) & 0xFF;
-    const uint8_t bg_a = (config.bg_color >> 0) & 0xFF;
+        display.unpack_colors(y, row_pixels.data());
+        for (std::size_t x = 0; x < width; ++x)
+            targets[x] = palette[row_pixels[x]];
 
-    for (std::size_t i = 0; i < display.size(); ++i) {
-        rect.x = static_cast<int>((i % config.window_width) * config.scale_factor);
-        rect.y = static_cast<int>((i / config.window_width) * config.scale_factor);
+        const bool fading = fade_span(&pixel_color_[y * width], targets.data(), width, weight);
 
-        if (display[i]) {
-            if (pixel_color_[i] != config.fg_color)
-                pixel_color_[i] = color_lerp(pixel_color_[i], config.fg_color, config.color_lerp_rate);
+        if (fading)
+            fading_rows_ |= uint64_t{ 1 } << y;
+        else
+            fading_rows_ &= ~(uint64_t{ 1 } << y);
 
-            const uint8_t r = (pixel_color_[i] >> 24) & 0xFF;
-            const uint8_t g = (pixel_color_[i] >> 16) & 0xFF;
-            const uint8_t b = (pixel_color_[i] >> 8) & 0xFF;
-            const uint8_t a = (pixel_color_[i] >> 0) & 0xFF;
+        if (y < first_row) first_row = y;
+        last_row = y;
+    }
 
-            SDL_SetRenderDrawColor(renderer_, r, g, b, a);
-            SDL_RenderFillRect(renderer_, &rect);
+    if (first_row <= last_row) {
+        const SDL_Rect dirty{ 0, static_cast<int>(first_row), static_cast<int>(width),
+                              static_cast<int>(last_row - first_row + 1) };
+        SDL_UpdateTexture(texture_, &dirty, &pixel_color_[first_row * width],
+                          static_cast<int>(width * sizeof(uint32_t)));
+    }
 
-            if (config.pixel_outlines) {
-                SDL_SetRenderDrawColor(renderer_, bg_r, bg_g, bg_b, bg_a);
-                SDL_RenderDrawRect(renderer_, &rect);
+    const SDL_Rect src{ 0, 0, static_cast<int>(width), static_cast<int>(height) };
+    SDL_RenderCopy(renderer_, texture_, &src, nullptr);
+
+    if (config.pixel_outlines) {
+        // Rebuild the outline list only when some row changed
+        if (display.dirty_rows() != 0 || resized) {
+            const int cell_w = static_cast<int>(config.window_width * config.scale_factor / width);
+            const int cell_h = static_cast<int>(config.window_height * config.scale_factor / height);
+
+            outline_rects_.clear();
+            for (std::size_t y = 0; y < height; ++y) {
+                display.unpack_colors(y, row_pixels.data());
+                for (std::size_t x = 0; x < width; ++x) {
+                    if (row_pixels[x])
+                        outline_rects_.push_back(SDL_Rect{ static_cast<int>(x) * cell_w, static_cast<int>(y) * cell_h,
+                                                           cell_w, cell_h });
+                }
             }
-        } else {
-            if (pixel_color_[i] != config.bg_color)
-                pixel_color_[i] = color_lerp(pixel_color_[i], config.bg_color, config.color_lerp_rate);
+        }
 
-            const uint8_t r = (pixel_color_[i] >> 24) & 0xFF;
-            const uint8_t g = (pixel_color_[i] >> 16) & 0xFF;
-            const uint8_t b = (pixel_color_[i] >> 8) & 0xFF;
-            const uint8_t a = (pixel_color_[i] >> 0) & 0xFF;
+        const uint8_t bg_r = (config.bg_color >> 24) & 0xFF;
+        const uint8_t bg_g = (config.bg_color >> 16) & 0xFF;
+        const uint8_t bg_b = (config.bg_color >> 8) & 0xFF;
+        const uint8_t bg_a = (config.bg_color >> 0) & 0xFF;
 
-            SDL_SetRenderDrawColor(renderer_, r, g, b, a);
-            SDL_RenderFillRect(renderer_, &rect);
-        }
+        SDL_SetRenderDrawColor(renderer_, bg_r, bg_g, bg_b, bg_a);
+        SDL_RenderDrawRects(renderer_, outline_rects_.data(), static_cast<int>(outline_rects_.size()));
     }
-
-    SDL_RenderPresent(renderer_);
 }
 
-uint32_t Display::color_lerp(uint32_t start_color, uint32_t end_color, float t) {
-    const auto lerp_channel = [t](uint8_t s, uint8_t e) -> uint8_t {
-        return static_cast<uint8_t>((1.0f - t) * s + t * e);
-    };
-
-    const uint8_t r = lerp_channel((start_color >> 24) & 0xFF, (end_color >> 24) & 0xFF);
-    const uint8_t g = lerp_channel((start_color >> 16) & 0xFF, (end_color >> 16) & 0xFF);
-    const uint8_t b = lerp_channel((start_color >> 8) & 0xFF, (end_color >> 8) & 0xFF);
-    const uint8_t a = lerp_channel((start_color >> 0) & 0xFF, (end_color >> 0) & 0xFF);
-
-    return (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16) | (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(a);
+void Display::present() {
+    SDL_RenderPresent(renderer_);
 }
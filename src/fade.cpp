@@ -0,0 +1,123 @@
+#include "../include/fade.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__SSE2__)
+#define CHIP8_FADE_SSE2 1
+#include <immintrin.h>
+#else
+#define CHIP8_FADE_SSE2 0
+#endif
+
+uint8_t fade_weight(float lerp_rate) {
+    if (!(lerp_rate > 0.0f)) return 0;
+    if (lerp_rate >= 1.0f) return 255;
+    const int w = static_cast<int>(lerp_rate * 256.0f + 0.5f);
+    return static_cast<uint8_t>(w > 255 ? 255 : w);
+}
+
+static inline uint32_t fade_pixel(uint32_t c, uint32_t t, uint32_t w) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const uint32_t cc   = (c >> shift) & 0xFF;
+        const uint32_t tc   = (t >> shift) & 0xFF;
+        const uint32_t bias = tc > cc ? 255 : 0;
+        out |= ((cc * (256 - w) + tc * w + bias) >> 8) << shift;
+    }
+    return out;
+}
+
+bool fade_span_scalar(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t weight) {
+    bool fading = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (colors[i] == targets[i]) continue;
+        colors[i] = fade_pixel(colors[i], targets[i], weight);
+        fading |= colors[i] != targets[i];
+    }
+    return fading;
+}
+
+#if CHIP8_FADE_SSE2
+// Lerps the eight 8-bit channels held in the low halves of c and t
+static inline __m128i fade_half_sse2(__m128i c, __m128i t, __m128i w, __m128i inv_w, __m128i bias_mask) {
+    const __m128i bias = _mm_and_si128(_mm_cmpgt_epi16(t, c), bias_mask);
+    __m128i sum        = _mm_add_epi16(_mm_mullo_epi16(c, inv_w), _mm_mullo_epi16(t, w));
+    sum                = _mm_add_epi16(sum, bias);
+    return _mm_srli_epi16(sum, 8);
+}
+
+static bool fade_span_sse2(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t weight) {
+    const __m128i zero      = _mm_setzero_si128();
+    const __m128i w         = _mm_set1_epi16(static_cast<short>(weight));
+    const __m128i inv_w     = _mm_set1_epi16(static_cast<short>(256 - weight));
+    const __m128i bias_mask = _mm_set1_epi16(0x00FF);
+
+    bool fading   = false;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(colors + i));
+        const __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i *>(targets + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(c, t)) == 0xFFFF) continue; // already settled
+
+        const __m128i lo  = fade_half_sse2(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(t, zero), w, inv_w, bias_mask);
+        const __m128i hi  = fade_half_sse2(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(t, zero), w, inv_w, bias_mask);
+        const __m128i out = _mm_packus_epi16(lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(colors + i), out);
+
+        fading |= _mm_movemask_epi8(_mm_cmpeq_epi32(out, t)) != 0xFFFF;
+    }
+    return fade_span_scalar(colors + i, targets + i, n - i, weight) || fading;
+}
+
+#if defined(__GNUC__)
+#define CHIP8_FADE_AVX2 1
+
+__attribute__((target("avx2"))) static inline __m256i fade_half_avx2(__m256i c, __m256i t, __m256i w, __m256i inv_w,
+                                                                     __m256i bias_mask) {
+    const __m256i bias = _mm256_and_si256(_mm256_cmpgt_epi16(t, c), bias_mask);
+    __m256i sum        = _mm256_add_epi16(_mm256_mullo_epi16(c, inv_w), _mm256_mullo_epi16(t, w));
+    sum                = _mm256_add_epi16(sum, bias);
+    return _mm256_srli_epi16(sum, 8);
+}
+
+__attribute__((target("avx2"))) static bool fade_span_avx2(uint32_t *colors, const uint32_t *targets, std::size_t n,
+                                                           uint8_t weight) {
+    const __m256i zero      = _mm256_setzero_si256();
+    const __m256i w         = _mm256_set1_epi16(static_cast<short>(weight));
+    const __m256i inv_w     = _mm256_set1_epi16(static_cast<short>(256 - weight));
+    const __m256i bias_mask = _mm256_set1_epi16(0x00FF);
+
+    bool fading   = false;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(colors + i));
+        const __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(targets + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(c, t)) == -1) continue; // already settled
+
+        // unpack/pack work within 128-bit lanes, so the pair round-trips in order
+        const __m256i lo  = fade_half_avx2(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(t, zero), w, inv_w, bias_mask);
+        const __m256i hi  = fade_half_avx2(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(t, zero), w, inv_w, bias_mask);
+        const __m256i out = _mm256_packus_epi16(lo, hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(colors + i), out);
+
+        fading |= _mm256_movemask_epi8(_mm256_cmpeq_epi32(out, t)) != -1;
+    }
+    return fade_span_sse2(colors + i, targets + i, n - i, weight) || fading;
+}
+#else
+#define CHIP8_FADE_AVX2 0
+#endif
+#endif // CHIP8_FADE_SSE2
+
+bool fade_span(uint32_t *colors, const uint32_t *targets, std::size_t n, uint8_t weight) {
+#if CHIP8_FADE_SSE2
+#if CHIP8_FADE_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) return fade_span_avx2(colors, targets, n, weight);
+#endif
+    return fade_span_sse2(colors, targets, n, weight);
+#else
+    return fade_span_scalar(colors, targets, n, weight);
+#endif
+}
@@ -0,0 +1,158 @@
+#include "../include/chip8.hpp"
+#include "../include/config.hpp"
+#include "../include/movie.hpp"
+#include "../include/rom_library.hpp"
+#include "../include/run_ahead.hpp"
+#include "../include/scheduler.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Headless "turbo" frontend: runs a ROM with no display, audio or frame
+// pacing, as fast as the host allows, and reports emulation throughput.
+// With --replay it plays back a recorded input movie and checks that the
+// run ends on the same display as the recording did. --run-ahead K adds the
+// speculative frames a windowed run-ahead would compute, to measure them.
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <rom_path> [--instructions N] [--frames N] [--seed N]"
+                  << " [--replay MOVIE] [options]\n";
+        return EXIT_FAILURE;
+    }
+
+    Config config;
+    if (!set_config_from_args(config, argc, argv))
+        return EXIT_FAILURE;
+
+    RomLibrary library;
+    if (!config.rom_db_path.empty() && !library.load_database(config.rom_db_path))
+        return EXIT_FAILURE;
+    const std::shared_ptr<const RomImage> rom = library.open(argv[1]);
+    if (!rom || !library.configure(config, *rom, argc, argv))
+        return EXIT_FAILURE;
+
+    Chip8 chip8(rom);
+    if (chip8.get_state() == EmulatorState::QUIT)
+        return EXIT_FAILURE;
+
+    // A movie fixes the seed, timing, quirks and length of the run
+    Movie movie;
+    const bool replaying = !config.replay_path.empty();
+    if (replaying) {
+        if (!movie.load(config.replay_path))
+            return EXIT_FAILURE;
+        if (movie.header().rom_hash != chip8.rom_hash()) {
+            std::cerr << "Error: \"" << config.replay_path << "\" was recorded with a different ROM.\n";
+            return EXIT_FAILURE;
+        }
+        movie.apply_settings(config);
+        config.max_instructions = 0;
+    }
+    if (config.seed >= 0)
+        chip8.seed_rng(static_cast<uint32_t>(config.seed));
+
+    Tracer tracer(true); // nothing here is real time, so never drop records
+    if (!config.trace_path.empty()) {
+        if (!tracer.start(config.trace_path, chip8.rom_hash()))
+            return EXIT_FAILURE;
+        chip8.set_tracer(&tracer);
+    }
+
+    // Speculative frames would show up in profiles and traces
+    RunAhead ahead(config.run_ahead);
+    if (ahead.enabled() && (!config.profile_path.empty() || !config.trace_path.empty())) {
+        std::cerr << "Note: run-ahead is off while profiling or tracing.\n";
+        ahead = RunAhead();
+    }
+    SaveState snapshot;
+
+    // Nothing to stop on: default to 10 seconds of emulated time
+    if (config.max_instructions == 0 && config.max_frames == 0)
+        config.max_frames = 600;
+
+    // Same per-frame instruction split as the windowed frontend, minus the waiting
+    Scheduler scheduler(config.insts_per_second);
+    uint64_t instructions = 0;
+    uint64_t frames       = 0;
+    bool done             = false;
+    std::size_t cursor    = 0; // next movie event
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (!done && chip8.get_state() != EmulatorState::QUIT) {
+        if (replaying) movie.input().apply(chip8, frames, cursor);
+
+        uint32_t batch = scheduler.instructions_for_frame();
+        if (config.max_instructions != 0 && config.max_instructions - instructions <= batch) {
+            batch = static_cast<uint32_t>(config.max_instructions - instructions);
+            done  = true;
+        }
+        chip8.run(config, batch);
+        instructions += batch;
+
+        chip8.update_timers();
+        if (ahead.enabled()) {
+            chip8.save_state(snapshot);
+            ahead.speculate(chip8, config, scheduler);
+            ahead.restore(chip8, snapshot);
+        }
+        if (++frames == config.max_frames) done = true;
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    chip8.set_tracer(nullptr);
+    tracer.stop();
+
+    const double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+    // Nothing is rendered or paced here, so all host time is execution
+    PerfCounters &perf = chip8.perf();
+    perf.frames        = frames;
+    const uint64_t run_ahead_ns = perf.stage_ns[static_cast<std::size_t>(Stage::RUN_AHEAD)];
+    perf.stage_ns[static_cast<std::size_t>(Stage::EXECUTE)] =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) -
+        run_ahead_ns;
+    const double ips       = elapsed_s > 0.0 ? static_cast<double>(instructions) / elapsed_s : 0.0;
+
+    const std::string title = library.settings(*rom).title;
+    std::cout << "ROM:          " << argv[1] << (title.empty() ? "" : " (" + title + ")") << '\n'
+              << "Instructions: " << instructions << '\n'
+              << "Frames:       " << frames << '\n'
+              << std::fixed << std::setprecision(3)
+              << "Elapsed:      " << elapsed_s * 1000.0 << " ms\n"
+              << std::setprecision(0)
+              << "Throughput:   " << ips << " instructions/s ("
+              << std::setprecision(1) << ips / config.insts_per_second << "x realtime)\n"
+              << "Idle:         " << perf.idle_instructions << " instructions skipped ("
+              << (instructions ? 100.0 * static_cast<double>(perf.idle_instructions) / static_cast<double>(instructions) : 0.0)
+              << "%)\n"
+              << "Draws:        " << perf.draws << " (" << perf.sprite_rows << " sprite rows, "
+              << perf.collisions << " collisions)\n"
+              << "Display hash: 0x" << std::hex << std::setw(16) << std::setfill('0')
+              << chip8.display_hash() << std::dec << std::setfill(' ') << '\n';
+    if (ahead.enabled())
+        std::cout << std::setprecision(2) << "Run-ahead:    " << ahead.frames() << " frames, "
+                  << static_cast<double>(run_ahead_ns) / 1e3 / static_cast<double>(frames ? frames : 1)
+                  << " us per frame\n";
+
+    if (!config.profile_path.empty() && save_perf_json(config.profile_path, perf, chip8.pc_profile()))
+        std::cout << "Profile:      " << config.profile_path << '\n';
+    if (!config.trace_path.empty())
+        std::cout << "Trace:        " << config.trace_path << " (" << tracer.written() << " records, "
+                  << tracer.dropped() << " dropped)\n";
+
+    if (!replaying)
+        return EXIT_SUCCESS;
+
+    const bool in_sync = frames == movie.header().frames && chip8.display_hash() == movie.header().final_hash;
+    if (in_sync)
+        std::cout << "Replay:       OK, matches the recording\n";
+    else
+        std::cout << "Replay:       DESYNC, recording ended on 0x" << std::hex << std::setw(16)
+                  << std::setfill('0') << movie.header().final_hash << std::dec << '\n';
+    return in_sync ? EXIT_SUCCESS : EXIT_FAILURE;
+}
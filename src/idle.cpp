@@ -0,0 +1,108 @@
+#include "../include/chip8.hpp"
+
+#include <array>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Idle-loop fast-forward
+// ---------------------------------------------------------------------------
+// Within one run() the keypad and timers never change, so a loop that only
+// reads them and shuffles registers either makes progress on its first pass
+// or spins identically until the frame ends: a DT poll (FX07 / 3X00 / 1NNN),
+// an FX0A key wait, a 1NNN jump to itself. Such a loop is run once on the
+// interpreter; if it comes back to its head with every register as it was,
+// the remaining whole passes are skipped. The skipped passes would not have
+// changed anything, so machine state stays bit-identical to running them.
+
+// Ops whose only effects are on registers, PC and the timers, and which
+// depend only on those, RAM and the keypad. Stack, RAM, display, RNG and
+// audio writers are left out.
+bool Chip8::idle_safe(uint16_t opcode) {
+    switch ((opcode >> 12) & 0x0F) {
+        case 0x01:
+        case 0x03:
+        case 0x04:
+        case 0x06:
+        case 0x07:
+        case 0x08:
+        case 0x0A:
+        case 0x0B: return true;
+        case 0x05:
+        case 0x09: return (opcode & 0x000F) == 0;
+        case 0x0E: return (opcode & 0x00FF) == 0x9E || (opcode & 0x00FF) == 0xA1;
+        case 0x0F:
+            if (opcode == 0xF000) return true; // long I
+            switch (opcode & 0x00FF) {
+                case 0x07: case 0x0A: case 0x15: case 0x18:
+                case 0x1E: case 0x29: case 0x30: case 0x65: return true;
+                default: return false;
+            }
+        default: return false;
+    }
+}
+
+// Called by try_skip_idle() with PC_ at a loop head, just after control
+// jumped back to it, unless the head is waiting out a miss. Passes through the loop are run until the registers repeat (Brent's cycle
+// detection, so a key scan that steps VX through 0-F is caught as well as a
+// one-pass DT poll), then the remaining whole cycles are skipped. Executes up
+// to `budget` instructions and returns how many were executed or skipped.
+uint32_t Chip8::skip_idle(const Config &config, uint32_t budget) {
+    const uint16_t head = PC_;
+    IdleMiss &miss      = idle_miss_slot(head);
+
+    // Everything a safe op can change, PC aside
+    struct Regs {
+        std::array<uint8_t, 16> V;
+        uint16_t I;
+        uint8_t delay, sound, fx0a_key;
+        bool fx0a_waiting;
+        bool operator==(const Regs &o) const {
+            return V == o.V && I == o.I && delay == o.delay && sound == o.sound && fx0a_key == o.fx0a_key &&
+                   fx0a_waiting == o.fx0a_waiting;
+        }
+    };
+    const auto regs = [this] { return Regs{ V_, I_, delay_timer_, sound_timer_, fx0a_key_, fx0a_waiting_ }; };
+
+    Regs saved        = regs();
+    uint32_t saved_at = 0; // instructions executed when `saved` was taken
+    uint32_t power = 1, passes = 0;
+    uint32_t executed = 0;
+    for (;;) {
+        // One pass, as long as every op in it is side-effect free
+        do {
+            if (executed == budget) return executed; // frame ends first
+            if (executed == MAX_IDLE_LOOP) {
+                idle_miss(miss, head, IDLE_PROGRESS_MISS_WAIT); // still making progress
+                return executed;
+            }
+            if (!idle_safe(fetch(PC_))) {
+                idle_miss(miss, head, IDLE_STATIC_MISS_WAIT);
+                return executed;
+            }
+            execute(config);
+            ++executed;
+        } while (PC_ != head);
+
+        if (regs() == saved) break;
+        if (++passes == power) {
+            saved    = regs();
+            saved_at = executed;
+            power *= 2;
+            passes = 0;
+        }
+    }
+
+    // A cycle: every later run through it repeats this one
+    if (miss.head == head) miss = {};
+    const uint32_t length  = executed - saved_at;
+    const uint32_t rest    = budget - executed;
+    const uint32_t skipped = rest - rest % length;
+    perf_.idle_instructions += skipped;
+    return executed + skipped;
+}
+
+void Chip8::idle_miss(IdleMiss &miss, uint16_t head, uint32_t wait) {
+    if (miss.head != head) miss = { head, 0, 0 };
+    else if (miss.strikes < MAX_IDLE_STRIKES) ++miss.strikes;
+    miss.wait = wait << miss.strikes;
+}
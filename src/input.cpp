@@ -0,0 +1,143 @@
+#include "../include/input.hpp"
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_keycode.h>
+
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// Keyboard -> CHIP-8 keypad (QWERTY layout); returns 0xFF for unmapped keys
+// ---------------------------------------------------------------------------
+static uint8_t map_key(SDL_Keycode sym) {
+    switch (sym) {
+        case SDLK_1: return 0x1;
+        case SDLK_2: return 0x2;
+        case SDLK_3: return 0x3;
+        case SDLK_4: return 0xC;
+
+        case SDLK_q: return 0x4;
+        case SDLK_w: return 0x5;
+        case SDLK_e: return 0x6;
+        case SDLK_r: return 0xD;
+
+        case SDLK_a: return 0x7;
+        case SDLK_s: return 0x8;
+        case SDLK_d: return 0x9;
+        case SDLK_f: return 0xE;
+
+        case SDLK_z: return 0xA;
+        case SDLK_x: return 0x0;
+        case SDLK_c: return 0xB;
+        case SDLK_v: return 0xF;
+
+        default: return 0xFF;
+    }
+}
+
+void handle_input(InputQueue &queue, Config &config) {
+    const auto send = [&](InputMessage::Type type, uint8_t key = 0, bool down = false, int16_t value = 0) {
+        InputMessage event;
+        event.type  = type;
+        event.key   = key;
+        event.down  = down;
+        event.value = value;
+        queue.push(event);
+    };
+
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
+
+            case SDL_QUIT:
+                send(InputMessage::QUIT);
+                break;
+
+            case SDL_KEYDOWN:
+                switch (event.key.keysym.sym) {
+
+                    case SDLK_ESCAPE:
+                        send(InputMessage::QUIT);
+                        break;
+
+                    case SDLK_SPACE:
+                        send(InputMessage::PAUSE);
+                        break;
+
+                    case SDLK_EQUALS:
+                        send(InputMessage::RESET);
+                        break;
+
+                    case SDLK_j:
+                        if (config.color_lerp_rate > 0.1f) config.color_lerp_rate -= 0.1f;
+                        break;
+
+                    case SDLK_k:
+                        if (config.color_lerp_rate < 1.0f) config.color_lerp_rate += 0.1f;
+                        break;
+
+                    // The emulation thread renders audio, so it gets the new volume
+                    case SDLK_o:
+                        if (config.volume > 0) config.volume -= 500;
+                        send(InputMessage::VOLUME, 0, false, config.volume);
+                        break;
+
+                    case SDLK_p:
+                        if (config.volume < INT16_MAX) config.volume += 500;
+                        send(InputMessage::VOLUME, 0, false, config.volume);
+                        break;
+
+                    case SDLK_F2:
+                        send(InputMessage::DUMP_PERF);
+                        break;
+
+                    case SDLK_F3:
+                        send(InputMessage::TOGGLE_TRACE);
+                        break;
+
+                    case SDLK_F5:
+                        send(InputMessage::SAVE_STATE);
+                        break;
+
+                    case SDLK_F9:
+                        send(InputMessage::LOAD_STATE);
+                        break;
+
+                    case SDLK_BACKSPACE:
+                        send(InputMessage::REWIND, 0, true);
+                        break;
+
+                    default: {
+                        const uint8_t key = map_key(event.key.keysym.sym);
+                        if (key != 0xFF) send(InputMessage::KEY, key, true);
+                        break;
+                    }
+                }
+                break; // SDL_KEYDOWN
+
+            case SDL_KEYUP: {
+                if (event.key.keysym.sym == SDLK_BACKSPACE) send(InputMessage::REWIND, 0, false);
+                const uint8_t key = map_key(event.key.keysym.sym);
+                if (key != 0xFF) send(InputMessage::KEY, key, false);
+                break; // SDL_KEYUP
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+void apply_input(const InputMessage &event, Chip8 &chip8, Config &config, InputActions &actions) {
+    switch (event.type) {
+        case InputMessage::KEY: chip8.set_key(event.key, event.down); break;
+        case InputMessage::PAUSE: chip8.toggle_pause(); break;
+        case InputMessage::QUIT: chip8.quit(); break;
+        case InputMessage::RESET: actions.reset = true; break;
+        case InputMessage::SAVE_STATE: actions.save_state = true; break;
+        case InputMessage::LOAD_STATE: actions.load_state = true; break;
+        case InputMessage::REWIND: actions.rewinding = event.down; break;
+        case InputMessage::DUMP_PERF: actions.dump_perf = true; break;
+        case InputMessage::TOGGLE_TRACE: actions.toggle_trace = true; break;
+        case InputMessage::VOLUME: config.volume = event.value; break;
+    }
+}
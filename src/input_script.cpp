@@ -0,0 +1,57 @@
+#include "../include/input_script.hpp"
+#include "../include/chip8.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool InputScript::load(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: input script \"" << path << "\" cannot be opened.\n";
+        return false;
+    }
+
+    std::string line;
+    for (std::size_t line_no = 1; std::getline(file, line); ++line_no) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+
+        uint64_t frame = 0;
+        std::string key, action;
+        if (!(fields >> frame)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            std::cerr << "Error: " << path << ":" << line_no << ": expected a frame number\n";
+            return false;
+        }
+
+        unsigned long key_value = 16;
+        if (fields >> key >> action) {
+            try {
+                key_value = std::stoul(key, nullptr, 16);
+            } catch (const std::exception &) {
+            }
+        }
+        if (key_value > 0x0F || (action != "down" && action != "up")) {
+            std::cerr << "Error: " << path << ":" << line_no << ": expected `<frame> <key 0-F> <down|up>`\n";
+            return false;
+        }
+        add({ frame, static_cast<uint8_t>(key_value), action == "down" });
+    }
+    return true;
+}
+
+void InputScript::add(const InputEvent &event) {
+    // Keep frame order; events within one frame stay in insertion order
+    const auto at = std::upper_bound(events_.begin(), events_.end(), event.frame,
+                                     [](uint64_t frame, const InputEvent &e) { return frame < e.frame; });
+    events_.insert(at, event);
+}
+
+void InputScript::apply(Chip8 &chip8, uint64_t frame, std::size_t &cursor) const {
+    while (cursor < events_.size() && events_[cursor].frame <= frame) {
+        chip8.set_key(events_[cursor].key, events_[cursor].pressed);
+        ++cursor;
+    }
+}
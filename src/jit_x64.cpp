@@ -0,0 +1,482 @@
+#include "../include/chip8.hpp"
+#include "../include/jit.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define CHIP8_JIT_X64 1
+#include <sys/mman.h>
+#else
+#define CHIP8_JIT_X64 0
+#endif
+
+// ---------------------------------------------------------------------------
+// Executable memory
+// ---------------------------------------------------------------------------
+// The region is kept W^X: it is flipped to read/write only while a block is
+// being copied in.
+JitCache::JitCache() {
+#if CHIP8_JIT_X64
+    void *mem = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem != MAP_FAILED) code_ = static_cast<uint8_t *>(mem);
+#endif
+}
+
+JitCache::~JitCache() {
+#if CHIP8_JIT_X64
+    if (code_) munmap(code_, CODE_SIZE);
+#endif
+}
+
+void JitCache::clear() {
+    drain_counts(drained_);
+    exits_.clear();
+    entries_.fill(Entry{});
+    ops_.clear();
+    code_used_ = 0;
+}
+
+JitCache::BlockFn JitCache::install(const std::vector<uint8_t> &code) {
+#if CHIP8_JIT_X64
+    if (!code_ || code_used_ + code.size() > CODE_SIZE) return nullptr;
+
+    if (mprotect(code_, CODE_SIZE, PROT_READ | PROT_WRITE) != 0) return nullptr;
+    uint8_t *dst = code_ + code_used_;
+    std::memcpy(dst, code.data(), code.size());
+    if (mprotect(code_, CODE_SIZE, PROT_READ | PROT_EXEC) != 0) return nullptr;
+
+    code_used_ = (code_used_ + code.size() + 15) & ~std::size_t{ 15 };
+
+    BlockFn fn;
+    std::memcpy(&fn, &dst, sizeof fn); // object -> function pointer without a cast warning
+    return fn;
+#else
+    (void)code;
+    return nullptr;
+#endif
+}
+
+const DecodedInst *JitCache::keep(const DecodedInst &inst) {
+    ops_.push_back(inst);
+    return &ops_.back();
+}
+
+JitCache::ExitCounter *JitCache::add_exit(const std::array<uint16_t, 16> &retired) {
+    exits_.emplace_back();
+    exits_.back().retired = retired;
+    return &exits_.back();
+}
+
+void JitCache::drain_counts(std::array<uint64_t, 16> &op_class) {
+    for (ExitCounter &exit : exits_) {
+        if (exit.runs == 0) continue;
+        for (std::size_t c = 0; c < op_class.size(); ++c) op_class[c] += exit.runs * exit.retired[c];
+        exit.runs = 0;
+    }
+    if (&op_class != &drained_) {
+        for (std::size_t c = 0; c < op_class.size(); ++c) op_class[c] += drained_[c];
+        drained_.fill(0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Code generation
+// ---------------------------------------------------------------------------
+// Register assignment inside a compiled block:
+//   rbx  = &V_[0]     (V registers are addressed as [rbx + X])
+//   r12  = Chip8*
+//   r13d = I_         (loaded on entry, written back at exits/handler calls)
+//   r14  = const Config*
+// PC_ is a compile-time constant within a block and is only materialised on
+// exit or before calling back into an interpreter handler. The exit path
+// expects edx = new PC and eax = instructions executed.
+// Every exit also bumps its own run counter; the opcode classes it retires
+// are known at compile time, so per-class instruction counts cost one add per
+// block run rather than one per instruction.
+class JitCompiler {
+public:
+    JitCompiler(Chip8 &chip8, JitCache &cache) : c_(chip8), cache_(cache) {
+        const auto base = reinterpret_cast<const char *>(&chip8);
+        off_V_          = static_cast<int32_t>(reinterpret_cast<const char *>(chip8.V_.data()) - base);
+        off_I_          = static_cast<int32_t>(reinterpret_cast<const char *>(&chip8.I_) - base);
+        off_PC_         = static_cast<int32_t>(reinterpret_cast<const char *>(&chip8.PC_) - base);
+        off_dirty_      = static_cast<int32_t>(reinterpret_cast<const char *>(&chip8.blocks_dirty_) - base);
+    }
+
+    // Compiles the block at `start`; returns false if the code region is full
+    bool compile(uint16_t start);
+
+private:
+    Chip8 &c_;
+    JitCache &cache_;
+    std::vector<uint8_t> code_;
+    std::vector<std::size_t> exit_jumps_; // rel32 fields patched to the epilogue
+    int32_t off_V_ = 0, off_I_ = 0, off_PC_ = 0, off_dirty_ = 0;
+    std::array<uint16_t, 16> retired_{}; // opcode classes compiled so far, current op included
+
+    void emit(std::initializer_list<uint8_t> bytes) { code_.insert(code_.end(), bytes); }
+    void emit32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) code_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void emit64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) code_.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+
+    // 8-bit ops on [rbx + disp8]; reg is al = 0, cl = 1, dl = 2
+    void op_rbx(uint8_t opcode, uint8_t reg, uint8_t disp) {
+        emit({ opcode, static_cast<uint8_t>(0x43 | (reg << 3)), disp });
+    }
+    void load_al(uint8_t x) { op_rbx(0x8A, 0, x); }  // mov al, [rbx+x]
+    void store_al(uint8_t x) { op_rbx(0x88, 0, x); } // mov [rbx+x], al
+    void store_cl(uint8_t x) { op_rbx(0x88, 1, x); } // mov [rbx+x], cl
+    void store_imm(uint8_t x, uint8_t v) {           // mov byte [rbx+x], imm8
+        op_rbx(0xC6, 0, x);
+        emit({ v });
+    }
+
+    void store_pc_imm(uint16_t pc) { // mov word [r12+PC], imm16
+        emit({ 0x66, 0x41, 0xC7, 0x84, 0x24 });
+        emit32(static_cast<uint32_t>(off_PC_));
+        emit({ static_cast<uint8_t>(pc), static_cast<uint8_t>(pc >> 8) });
+    }
+    void load_pc_edx() { // movzx edx, word [r12+PC]
+        emit({ 0x41, 0x0F, 0xB7, 0x94, 0x24 });
+        emit32(static_cast<uint32_t>(off_PC_));
+    }
+    void spill_i() { // mov [r12+I], r13w
+        emit({ 0x66, 0x45, 0x89, 0xAC, 0x24 });
+        emit32(static_cast<uint32_t>(off_I_));
+    }
+    void reload_i() { // movzx r13d, word [r12+I]
+        emit({ 0x45, 0x0F, 0xB7, 0xAC, 0x24 });
+        emit32(static_cast<uint32_t>(off_I_));
+    }
+    void mov_eax(uint32_t v) { emit({ 0xB8 }); emit32(v); }
+    void mov_edx(uint32_t v) { emit({ 0xBA }); emit32(v); }
+    void mov_ecx(uint32_t v) { emit({ 0xB9 }); emit32(v); }
+
+    void count_retired() { // inc qword [counter of this exit]
+        const JitCache::ExitCounter *exit = cache_.add_exit(retired_);
+        emit({ 0x48, 0xB9 }); // mov rcx, imm64
+        emit64(reinterpret_cast<uint64_t>(&exit->runs));
+        emit({ 0x48, 0xFF, 0x01 }); // inc qword [rcx]
+    }
+
+    void jmp_exit() {
+        count_retired();
+        emit({ 0xE9 });
+        exit_jumps_.push_back(code_.size());
+        emit32(0);
+    }
+
+    void prologue();
+    void epilogue();
+    void call_handler(const DecodedInst &inst, uint16_t next_pc);
+    bool emit_native(const DecodedInst &inst, uint16_t addr, uint32_t index, const Dialect &dialect);
+};
+
+void JitCompiler::prologue() {
+    emit({ 0x53 });                   // push rbx
+    emit({ 0x55 });                   // push rbp (keeps rsp 16-byte aligned for calls)
+    emit({ 0x41, 0x54 });             // push r12
+    emit({ 0x41, 0x55 });             // push r13
+    emit({ 0x41, 0x56 });             // push r14
+    emit({ 0x49, 0x89, 0xFC });       // mov r12, rdi
+    emit({ 0x49, 0x89, 0xF6 });       // mov r14, rsi
+    emit({ 0x49, 0x8D, 0x9C, 0x24 }); // lea rbx, [r12+V]
+    emit32(static_cast<uint32_t>(off_V_));
+    reload_i();
+}
+
+void JitCompiler::epilogue() {
+    const std::size_t target = code_.size();
+    for (const std::size_t at : exit_jumps_) {
+        const auto rel = static_cast<uint32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(at + 4));
+        for (int i = 0; i < 4; ++i) code_[at + i] = static_cast<uint8_t>(rel >> (8 * i));
+    }
+
+    emit({ 0x66, 0x41, 0x89, 0x94, 0x24 }); // mov [r12+PC], dx
+    emit32(static_cast<uint32_t>(off_PC_));
+    spill_i();
+    emit({ 0x41, 0x5E }); // pop r14
+    emit({ 0x41, 0x5D }); // pop r13
+    emit({ 0x41, 0x5C }); // pop r12
+    emit({ 0x5D });       // pop rbp
+    emit({ 0x5B });       // pop rbx
+    emit({ 0xC3 });       // ret
+}
+
+// Falls back to the interpreter handler for one instruction
+void JitCompiler::call_handler(const DecodedInst &inst, uint16_t next_pc) {
+    const DecodedInst *kept = cache_.keep(inst);
+
+    spill_i();
+    store_pc_imm(next_pc);
+    emit({ 0x4C, 0x89, 0xE7 }); // mov rdi, r12
+    emit({ 0x48, 0xBE });       // mov rsi, imm64
+    emit64(reinterpret_cast<uint64_t>(kept));
+    emit({ 0x4C, 0x89, 0xF2 }); // mov rdx, r14
+    emit({ 0x48, 0xB8 });       // mov rax, imm64
+    emit64(reinterpret_cast<uint64_t>(inst.fn));
+    emit({ 0xFF, 0xD0 }); // call rax
+    reload_i();
+}
+
+// Emits host code for the ops worth inlining; returns false for ops that go
+// through call_handler. Skips and jumps end the block and exit directly.
+bool JitCompiler::emit_native(const DecodedInst &d, uint16_t addr, uint32_t index, const Dialect &dialect) {
+    const bool vf_reset = dialect.quirks & QUIRK_VF_RESET;
+    const bool shift_vy = dialect.quirks & QUIRK_SHIFT_VY;
+    const uint8_t X = d.X, Y = d.Y, VF = 0xF;
+
+    // Skip: edx = PC + 2, or PC + 4 when the condition holds. On XO-CHIP a
+    // skipped F000 NNNN is four bytes; the word is read now and covered by
+    // the block, so rewriting it recompiles the skip.
+    const auto skip_exit = [&](uint8_t cmov) {
+        uint16_t skip_to = static_cast<uint16_t>(addr + 4u);
+        if (dialect.extension == Extension::XOCHIP && addr + 3u < Chip8::RAM_SIZE) {
+            c_.block_cover_[addr + 2u - Chip8::ROM_START] = 1;
+            c_.block_cover_[addr + 3u - Chip8::ROM_START] = 1;
+            if (c_.fetch(static_cast<uint16_t>(addr + 2u)) == 0xF000) skip_to = static_cast<uint16_t>(addr + 6u);
+        }
+        mov_edx(addr + 2u);
+        mov_ecx(skip_to);
+        emit({ 0x0F, cmov, 0xD1 }); // cmovcc edx, ecx
+        mov_eax(index + 1);
+        jmp_exit();
+    };
+
+    switch ((d.opcode >> 12) & 0x0F) {
+        case 0x01: // 1NNN
+            mov_edx(d.NNN);
+            mov_eax(index + 1);
+            jmp_exit();
+            return true;
+
+        case 0x03: // 3XNN
+            load_al(X);
+            emit({ 0x3C, d.NN }); // cmp al, imm8
+            skip_exit(0x44);      // cmove
+            return true;
+
+        case 0x04: // 4XNN
+            load_al(X);
+            emit({ 0x3C, d.NN });
+            skip_exit(0x45); // cmovne
+            return true;
+
+        case 0x05: // 5XY0
+            if (d.N != 0) return false;
+            load_al(X);
+            op_rbx(0x3A, 0, Y); // cmp al, [rbx+Y]
+            skip_exit(0x44);
+            return true;
+
+        case 0x09: // 9XY0
+            load_al(X);
+            op_rbx(0x3A, 0, Y);
+            skip_exit(0x45);
+            return true;
+
+        case 0x06: // 6XNN
+            store_imm(X, d.NN);
+            return true;
+
+        case 0x07: // 7XNN: add byte [rbx+X], imm8
+            op_rbx(0x80, 0, X);
+            emit({ d.NN });
+            return true;
+
+        case 0x08:
+            switch (d.N) {
+                case 0x0:
+                    load_al(Y);
+                    store_al(X);
+                    return true;
+                case 0x1:
+                case 0x2:
+                case 0x3: {
+                    static constexpr uint8_t alu[] = { 0x08, 0x20, 0x30 }; // or / and / xor [rbx+X], al
+                    load_al(Y);
+                    op_rbx(alu[d.N - 1], 0, X);
+                    if (vf_reset) store_imm(VF, 0);
+                    return true;
+                }
+                case 0x4:
+                    load_al(X);
+                    op_rbx(0x02, 0, Y);         // add al, [rbx+Y]
+                    emit({ 0x0F, 0x92, 0xC1 }); // setc cl
+                    store_al(X);
+                    store_cl(VF);
+                    return true;
+                case 0x5:
+                    load_al(X);
+                    op_rbx(0x2A, 0, Y);         // sub al, [rbx+Y]
+                    emit({ 0x0F, 0x93, 0xC1 }); // setnc cl
+                    store_al(X);
+                    store_cl(VF);
+                    return true;
+                case 0x7:
+                    load_al(Y);
+                    op_rbx(0x2A, 0, X); // sub al, [rbx+X]
+                    emit({ 0x0F, 0x93, 0xC1 });
+                    store_al(X);
+                    store_cl(VF);
+                    return true;
+                case 0x6: {
+                    // Same read/write order as the handler so X/Y == F behave identically
+                    const uint8_t src = shift_vy ? Y : X;
+                    load_al(src);
+                    emit({ 0x24, 0x01 }); // and al, 1
+                    store_al(VF);
+                    load_al(src);
+                    emit({ 0xD0, 0xE8 }); // shr al, 1
+                    store_al(X);
+                    return true;
+                }
+                case 0xE: {
+                    const uint8_t src = shift_vy ? Y : X;
+                    load_al(src);
+                    emit({ 0xC0, 0xE8, 0x07 }); // shr al, 7
+                    store_al(VF);
+                    load_al(src);
+                    emit({ 0x00, 0xC0 }); // add al, al
+                    store_al(X);
+                    return true;
+                }
+                default:
+                    return false;
+            }
+
+        case 0x0A: // ANNN: mov r13d, imm32
+            emit({ 0x41, 0xBD });
+            emit32(d.NNN);
+            return true;
+
+        case 0x0F:
+            switch (d.NN) {
+                case 0x1E:                            // FX1E: I += VX (16-bit wrap)
+                    emit({ 0x0F, 0xB6, 0x43, X });    // movzx eax, byte [rbx+X]
+                    emit({ 0x41, 0x01, 0xC5 });       // add r13d, eax
+                    emit({ 0x45, 0x0F, 0xB7, 0xED }); // movzx r13d, r13w
+                    return true;
+                case 0x29:                            // FX29: I = VX * 5
+                    emit({ 0x0F, 0xB6, 0x43, X });
+                    emit({ 0x44, 0x8D, 0x2C, 0x80 }); // lea r13d, [rax+rax*4]
+                    return true;
+                default:
+                    return false;
+            }
+
+        default:
+            return false;
+    }
+}
+
+bool JitCompiler::compile(uint16_t start) {
+    prologue();
+
+    uint16_t addr   = start;
+    uint32_t length = 0;
+    bool closed     = false; // last op already emitted its own exit
+
+    while (addr >= Chip8::ROM_START && addr < Chip8::RAM_SIZE - 1 && length < Chip8::MAX_BLOCK_LEN) {
+        const uint16_t opcode = c_.fetch(addr);
+        const DecodedInst d   = Chip8::decode(opcode, c_.dialect_);
+        const bool last       = Chip8::ends_block(opcode);
+        retired_[opcode >> 12]++;
+
+        c_.block_cover_[addr - Chip8::ROM_START]     = 1;
+        c_.block_cover_[addr + 1 - Chip8::ROM_START] = 1;
+
+        if (emit_native(d, addr, length, c_.dialect_)) {
+            closed = last;
+        } else {
+            call_handler(d, static_cast<uint16_t>(addr + 2));
+            if (last) {
+                // Control flow decided by the handler
+                load_pc_edx();
+                mov_eax(length + 1);
+                count_retired();
+                closed = true;
+            } else if ((d.opcode & 0xF0FF) == 0xF033 || (d.opcode & 0xF0FF) == 0xF055) {
+                // Wrote RAM: leave early if that hit compiled code
+                emit({ 0x41, 0x80, 0xBC, 0x24 }); // cmp byte [r12+dirty], 0
+                emit32(static_cast<uint32_t>(off_dirty_));
+                emit({ 0x00 });
+                emit({ 0x0F, 0x84 }); // je over the exit below
+                emit32(0);
+                const std::size_t skip_from = code_.size();
+                mov_edx(addr + 2u);
+                mov_eax(length + 1);
+                jmp_exit();
+                const auto skip = static_cast<uint32_t>(code_.size() - skip_from);
+                for (int i = 0; i < 4; ++i) code_[skip_from - 4 + i] = static_cast<uint8_t>(skip >> (8 * i));
+            }
+        }
+
+        ++length;
+        addr += 2;
+        if (last) break;
+    }
+
+    if (!closed) {
+        mov_edx(addr);
+        mov_eax(length);
+        count_retired();
+    }
+    epilogue();
+
+    const JitCache::BlockFn fn = cache_.install(code_);
+    if (!fn) return false;
+
+    JitCache::Entry &entry = cache_.entry(start - Chip8::ROM_START);
+    entry.fn               = fn;
+    entry.length           = static_cast<uint16_t>(length);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// JIT engine
+// ---------------------------------------------------------------------------
+// Cold blocks run on the basic-block engine; once a start address has been
+// seen HOT_THRESHOLD times it is compiled. Compiled blocks only run when the
+// whole block fits in the budget, so frame boundaries match the interpreter.
+uint32_t Chip8::run_jit(const Config &config, uint32_t budget) {
+    if (!jit_) jit_ = std::make_unique<JitCache>();
+    if (!jit_->available()) return run_block(config, budget);
+
+    // Chain blocks here rather than returning to run() after each one
+    uint32_t executed = 0;
+    while (executed < budget) {
+        const uint16_t pc = PC_;
+        const uint8_t sp  = sp_;
+        if (pc < ROM_START || pc >= RAM_SIZE - 1) break;
+
+        if (blocks_dirty_) flush_blocks();
+
+        JitCache::Entry *entry = &jit_->entry(pc - ROM_START);
+        if (!entry->fn && ++entry->heat >= JitCache::HOT_THRESHOLD) {
+            if (!JitCompiler(*this, *jit_).compile(pc)) {
+                // Out of code space: start over
+                jit_->clear();
+                JitCompiler(*this, *jit_).compile(pc);
+            }
+            entry = &jit_->entry(pc - ROM_START);
+        }
+
+        if (entry->fn && entry->length <= budget - executed)
+            executed += entry->fn(this, &config);
+        else
+            executed += run_block(config, budget - executed);
+        if (config.idle_skip && PC_ <= pc && sp_ == sp && executed < budget)
+            executed += try_skip_idle(config, budget - executed);
+    }
+    return executed;
+}
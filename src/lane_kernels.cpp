@@ -0,0 +1,303 @@
+#include "../include/lane_kernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CHIP8_LANES_AVX2 1
+#include <immintrin.h>
+#else
+#define CHIP8_LANES_AVX2 0
+#endif
+
+// ---------------------------------------------------------------------------
+// Portable kernels (also handle the tails of the vector loops)
+// ---------------------------------------------------------------------------
+static std::size_t match_scalar(const uint16_t *pc, uint16_t value, uint8_t *pending, uint8_t *group,
+                                std::size_t n) {
+    std::size_t count = 0;
+    for (std::size_t l = 0; l < n; ++l) {
+        const bool member = pending[l] && pc[l] == value;
+        group[l]          = member ? 0xFF : 0x00;
+        pending[l]        = member ? 0x00 : pending[l];
+        count += member;
+    }
+    return count;
+}
+
+static void alu_scalar(LaneAlu op, uint8_t *vx, const uint8_t *vy, uint8_t *vf, uint8_t nn, bool quirks,
+                       const uint8_t *mask, std::size_t n) {
+    static const uint8_t none = 0; // VY operand of the NN forms
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) lane_alu(op, vx[l], vy ? vy[l] : none, vf[l], nn, quirks);
+}
+
+static void skip_scalar(LaneSkip op, const uint8_t *vx, const uint8_t *vy, uint8_t nn, uint16_t *pc,
+                        const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l) {
+        if (!mask[l]) continue;
+        bool taken = false;
+        switch (op) {
+            case LaneSkip::EQ_NN: taken = vx[l] == nn; break;
+            case LaneSkip::NE_NN: taken = vx[l] != nn; break;
+            case LaneSkip::EQ: taken = vx[l] == vy[l]; break;
+            case LaneSkip::NE: taken = vx[l] != vy[l]; break;
+        }
+        if (taken) pc[l] += 2;
+    }
+}
+
+static void set16_scalar(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) dst[l] = value;
+}
+
+static void add16_scalar(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) dst[l] = static_cast<uint16_t>(dst[l] + value);
+}
+
+static void add16_u8_scalar(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) dst[l] = static_cast<uint16_t>(dst[l] + src[l]);
+}
+
+static void digit16_scalar(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) dst[l] = static_cast<uint16_t>(src[l] * 5);
+}
+
+static void copy8_scalar(uint8_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l)
+        if (mask[l]) dst[l] = src[l];
+}
+
+static void timers_scalar(uint8_t *delay, uint8_t *sound, uint8_t *beeping, std::size_t n) {
+    for (std::size_t l = 0; l < n; ++l) {
+        if (delay[l] > 0) --delay[l];
+        beeping[l] = sound[l] > 0;
+        if (beeping[l]) --sound[l];
+    }
+}
+
+static const LaneKernels SCALAR_KERNELS = {
+    match_scalar, alu_scalar,   skip_scalar,  set16_scalar,  add16_scalar,
+    add16_u8_scalar, digit16_scalar, copy8_scalar, timers_scalar, "scalar",
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels: 32 lanes of 8-bit state or 16 lanes of 16-bit state per op
+// ---------------------------------------------------------------------------
+#if CHIP8_LANES_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i load8(const uint8_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+AVX2 static inline void store8(uint8_t *p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+// Masked store: lanes outside the mask keep their current value
+AVX2 static inline void blend8(uint8_t *p, __m256i v, __m256i m) {
+    store8(p, _mm256_blendv_epi8(load8(p), v, m));
+}
+
+// 16 mask bytes widened to 16 mask words
+AVX2 static inline __m256i mask16(const uint8_t *mask) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask)));
+}
+
+AVX2 static inline __m256i load16(const uint16_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+AVX2 static inline void store16(uint16_t *p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+AVX2 static inline __m256i widen8(const uint8_t *p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+
+AVX2 static std::size_t match_avx2(const uint16_t *pc, uint16_t value, uint8_t *pending, uint8_t *group,
+                                   std::size_t n) {
+    const __m256i v   = _mm256_set1_epi16(static_cast<short>(value));
+    std::size_t count = 0;
+    std::size_t l     = 0;
+    for (; l + 32 <= n; l += 32) {
+        const __m256i lo = _mm256_cmpeq_epi16(load16(pc + l), v);
+        const __m256i hi = _mm256_cmpeq_epi16(load16(pc + l + 16), v);
+        // packs interleaves 128-bit halves; the permute restores lane order
+        const __m256i eq = _mm256_permute4x64_epi64(_mm256_packs_epi16(lo, hi), 0xD8);
+        const __m256i p  = load8(pending + l);
+        const __m256i m  = _mm256_and_si256(eq, p);
+        store8(group + l, m);
+        store8(pending + l, _mm256_andnot_si256(m, p));
+        count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(m))));
+    }
+    return count + match_scalar(pc + l, value, pending + l, group + l, n - l);
+}
+
+AVX2 static void alu_avx2(LaneAlu op, uint8_t *vx, const uint8_t *vy, uint8_t *vf, uint8_t nn, bool quirks,
+                          const uint8_t *mask, std::size_t n) {
+    const __m256i one  = _mm256_set1_epi8(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i imm  = _mm256_set1_epi8(static_cast<char>(nn));
+    const uint8_t *src = quirks ? vy : vx; // shift source
+
+    std::size_t l = 0;
+    for (; l + 32 <= n; l += 32) {
+        const __m256i m = load8(mask + l);
+        if (_mm256_testz_si256(m, m)) continue;
+
+        switch (op) {
+            case LaneAlu::SET_NN: blend8(vx + l, imm, m); break;
+            case LaneAlu::ADD_NN: blend8(vx + l, _mm256_add_epi8(load8(vx + l), imm), m); break;
+            case LaneAlu::MOV: blend8(vx + l, load8(vy + l), m); break;
+            case LaneAlu::OR:
+                blend8(vx + l, _mm256_or_si256(load8(vx + l), load8(vy + l)), m);
+                if (quirks) blend8(vf + l, zero, m);
+                break;
+            case LaneAlu::AND:
+                blend8(vx + l, _mm256_and_si256(load8(vx + l), load8(vy + l)), m);
+                if (quirks) blend8(vf + l, zero, m);
+                break;
+            case LaneAlu::XOR:
+                blend8(vx + l, _mm256_xor_si256(load8(vx + l), load8(vy + l)), m);
+                if (quirks) blend8(vf + l, zero, m);
+                break;
+            case LaneAlu::ADD: {
+                const __m256i a = load8(vx + l), b = load8(vy + l);
+                const __m256i r = _mm256_add_epi8(a, b);
+                // carry out of bit 7 <=> the wrapped sum is below an operand
+                const __m256i no_carry = _mm256_cmpeq_epi8(_mm256_max_epu8(a, r), r);
+                blend8(vx + l, r, m);
+                blend8(vf + l, _mm256_andnot_si256(no_carry, one), m);
+                break;
+            }
+            case LaneAlu::SUB: {
+                const __m256i a = load8(vx + l), b = load8(vy + l);
+                const __m256i f = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(a, b), a), one);
+                blend8(vx + l, _mm256_sub_epi8(a, b), m);
+                blend8(vf + l, f, m);
+                break;
+            }
+            case LaneAlu::SUBN: {
+                const __m256i a = load8(vx + l), b = load8(vy + l);
+                const __m256i f = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(a, b), b), one);
+                blend8(vx + l, _mm256_sub_epi8(b, a), m);
+                blend8(vf + l, f, m);
+                break;
+            }
+            case LaneAlu::SHR: {
+                blend8(vf + l, _mm256_and_si256(load8(src + l), one), m);
+                // Reload: the source may be VF, just written
+                const __m256i s = load8(src + l);
+                blend8(vx + l, _mm256_and_si256(_mm256_srli_epi16(s, 1), _mm256_set1_epi8(0x7F)), m);
+                break;
+            }
+            case LaneAlu::SHL: {
+                blend8(vf + l, _mm256_and_si256(_mm256_srli_epi16(load8(src + l), 7), one), m);
+                const __m256i s = load8(src + l);
+                blend8(vx + l, _mm256_add_epi8(s, s), m);
+                break;
+            }
+        }
+    }
+    alu_scalar(op, vx + l, vy ? vy + l : nullptr, vf + l, nn, quirks, mask + l, n - l);
+}
+
+AVX2 static void skip_avx2(LaneSkip op, const uint8_t *vx, const uint8_t *vy, uint8_t nn, uint16_t *pc,
+                           const uint8_t *mask, std::size_t n) {
+    const __m256i imm = _mm256_set1_epi8(static_cast<char>(nn));
+    const __m256i two = _mm256_set1_epi16(2);
+    const bool equal  = op == LaneSkip::EQ_NN || op == LaneSkip::EQ;
+    const bool reg    = op == LaneSkip::EQ || op == LaneSkip::NE;
+
+    std::size_t l = 0;
+    for (; l + 32 <= n; l += 32) {
+        __m256i taken = _mm256_cmpeq_epi8(load8(vx + l), reg ? load8(vy + l) : imm);
+        taken         = equal ? _mm256_and_si256(taken, load8(mask + l)) : _mm256_andnot_si256(taken, load8(mask + l));
+
+        const __m256i lo = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(taken));
+        const __m256i hi = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(taken, 1));
+        store16(pc + l, _mm256_add_epi16(load16(pc + l), _mm256_and_si256(lo, two)));
+        store16(pc + l + 16, _mm256_add_epi16(load16(pc + l + 16), _mm256_and_si256(hi, two)));
+    }
+    skip_scalar(op, vx + l, vy ? vy + l : nullptr, nn, pc + l, mask + l, n - l);
+}
+
+AVX2 static void set16_avx2(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n) {
+    const __m256i v = _mm256_set1_epi16(static_cast<short>(value));
+    std::size_t l   = 0;
+    for (; l + 16 <= n; l += 16)
+        store16(dst + l, _mm256_blendv_epi8(load16(dst + l), v, mask16(mask + l)));
+    set16_scalar(dst + l, value, mask + l, n - l);
+}
+
+AVX2 static void add16_avx2(uint16_t *dst, uint16_t value, const uint8_t *mask, std::size_t n) {
+    const __m256i v = _mm256_set1_epi16(static_cast<short>(value));
+    std::size_t l   = 0;
+    for (; l + 16 <= n; l += 16)
+        store16(dst + l, _mm256_add_epi16(load16(dst + l), _mm256_and_si256(v, mask16(mask + l))));
+    add16_scalar(dst + l, value, mask + l, n - l);
+}
+
+AVX2 static void add16_u8_avx2(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    std::size_t l = 0;
+    for (; l + 16 <= n; l += 16)
+        store16(dst + l, _mm256_add_epi16(load16(dst + l), _mm256_and_si256(widen8(src + l), mask16(mask + l))));
+    add16_u8_scalar(dst + l, src + l, mask + l, n - l);
+}
+
+AVX2 static void digit16_avx2(uint16_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    const __m256i five = _mm256_set1_epi16(5);
+    std::size_t l      = 0;
+    for (; l + 16 <= n; l += 16) {
+        const __m256i addr = _mm256_mullo_epi16(widen8(src + l), five);
+        store16(dst + l, _mm256_blendv_epi8(load16(dst + l), addr, mask16(mask + l)));
+    }
+    digit16_scalar(dst + l, src + l, mask + l, n - l);
+}
+
+AVX2 static void copy8_avx2(uint8_t *dst, const uint8_t *src, const uint8_t *mask, std::size_t n) {
+    std::size_t l = 0;
+    for (; l + 32 <= n; l += 32)
+        blend8(dst + l, load8(src + l), load8(mask + l));
+    copy8_scalar(dst + l, src + l, mask + l, n - l);
+}
+
+AVX2 static void timers_avx2(uint8_t *delay, uint8_t *sound, uint8_t *beeping, std::size_t n) {
+    const __m256i one = _mm256_set1_epi8(1);
+    std::size_t l     = 0;
+    for (; l + 32 <= n; l += 32) {
+        const __m256i s      = load8(sound + l);
+        const __m256i silent = _mm256_cmpeq_epi8(s, _mm256_setzero_si256());
+        store8(beeping + l, _mm256_andnot_si256(silent, one));
+        store8(delay + l, _mm256_subs_epu8(load8(delay + l), one)); // saturating: stops at 0
+        store8(sound + l, _mm256_subs_epu8(s, one));
+    }
+    timers_scalar(delay + l, sound + l, beeping + l, n - l);
+}
+
+static const LaneKernels AVX2_KERNELS = {
+    match_avx2, alu_avx2,   skip_avx2,  set16_avx2,  add16_avx2,
+    add16_u8_avx2, digit16_avx2, copy8_avx2, timers_avx2, "avx2",
+};
+
+#undef AVX2
+#endif // CHIP8_LANES_AVX2
+
+const LaneKernels &lane_kernels_scalar() {
+    return SCALAR_KERNELS;
+}
+
+const LaneKernels &lane_kernels() {
+#if CHIP8_LANES_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) return AVX2_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
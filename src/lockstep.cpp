@@ -0,0 +1,382 @@
+#include "../include/lockstep.hpp"
+#include "../include/fontset.hpp"
+#include "../include/rom_library.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// Construction
+// ---------------------------------------------------------------------------
+Lockstep::Lockstep(const std::string &rom_path, std::size_t lanes)
+    : lanes_(std::max<std::size_t>(lanes, 1)),
+      kernels_(lane_kernels()),
+      V_(16 * lanes_, 0),
+      I_(lanes_, 0),
+      PC_(lanes_, ROM_START),
+      stack_(STACK_SIZE * lanes_, 0),
+      sp_(lanes_, 0),
+      delay_timer_(lanes_, 0),
+      sound_timer_(lanes_, 0),
+      beeping_(lanes_, 0),
+      keypad_(lanes_, 0),
+      fx0a_key_(lanes_, 0xFF),
+      rpl_(lanes_),
+      ram_(lanes_),
+      display_(lanes_, FrameBuffer{ LORES_W, LORES_H }),
+      rng_(lanes_),
+      pending_(lanes_, 0),
+      group_(lanes_, 0) {
+    // Distinct default seeds; callers wanting a specific stream use seed_rng()
+    for (std::size_t l = 0; l < lanes_; ++l)
+        rng_[l].seed(static_cast<uint32_t>(l));
+
+    loaded_ = load_rom(rom_path);
+    if (!loaded_) return;
+    for (std::size_t l = 1; l < lanes_; ++l)
+        ram_[l] = ram_[0];
+
+    // COSMAC VIP two-page hires ROMs, as in Chip8::boot_vip_hires()
+    if (fetch(0, ROM_START) == 0x1260) {
+        std::fill(PC_.begin(), PC_.end(), VIP_HIRES_ENTRY);
+        for (FrameBuffer &display : display_) display.resize(LORES_W, HIRES_H);
+    }
+}
+
+// Same checks and messages as Chip8::load_rom; the image is loaded once into
+// lane 0 and copied to the others
+bool Lockstep::load_rom(const std::string &rom_path) {
+    std::array<uint8_t, RAM_SIZE> &ram = ram_[0];
+    ram.fill(0);
+    std::copy(FONTSET.begin(), FONTSET.end(), ram.begin());
+    std::copy(BIG_FONTSET.begin(), BIG_FONTSET.end(), ram.begin() + BIG_FONT_START);
+
+    const std::shared_ptr<const RomImage> rom = RomImage::open(rom_path);
+    if (!rom) return false;
+
+    constexpr std::size_t max_size = RAM_SIZE - ROM_START;
+    if (rom->size() > max_size) {
+        std::cerr << "Error: ROM \"" << rom_path << "\" is too large ("
+                  << rom->size() << " bytes; max " << max_size << ").\n";
+        return false;
+    }
+
+    std::copy(rom->data(), rom->data() + rom->size(), ram.begin() + ROM_START);
+    return true;
+}
+
+void Lockstep::seed_rng(std::size_t lane, uint32_t seed) {
+    rng_[lane].seed(seed);
+}
+
+void Lockstep::set_key(std::size_t lane, uint8_t key, bool pressed) {
+    const uint16_t bit = static_cast<uint16_t>(1u << (key & 0x0F));
+    keypad_[lane]      = pressed ? (keypad_[lane] | bit) : (keypad_[lane] & ~bit);
+}
+
+void Lockstep::update_timers() {
+    kernels_.timers(delay_timer_.data(), sound_timer_.data(), beeping_.data(), lanes_);
+}
+
+// ---------------------------------------------------------------------------
+// Memory
+// ---------------------------------------------------------------------------
+uint16_t Lockstep::fetch(std::size_t lane, uint16_t addr) const {
+    const std::array<uint8_t, RAM_SIZE> &ram = ram_[lane];
+    return static_cast<uint16_t>((ram[addr & (RAM_SIZE - 1)] << 8) | ram[(addr + 1) & (RAM_SIZE - 1)]);
+}
+
+void Lockstep::write_ram(std::size_t lane, uint16_t addr, uint8_t value) {
+    addr &= RAM_SIZE - 1;
+    ram_[lane][addr] = value;
+    written_[addr]   = 1;
+}
+
+Instruction Lockstep::split(uint16_t opcode) {
+    Instruction inst;
+    inst.opcode = opcode;
+    inst.NNN    = opcode & 0x0FFF;
+    inst.NN     = opcode & 0x00FF;
+    inst.N      = opcode & 0x000F;
+    inst.X      = (opcode >> 8) & 0x0F;
+    inst.Y      = (opcode >> 4) & 0x0F;
+    return inst;
+}
+
+// ---------------------------------------------------------------------------
+// Scalar execution of one instruction on one lane. PC has already been
+// advanced. Mirrors the handlers in chip8.cpp operation for operation.
+// ---------------------------------------------------------------------------
+void Lockstep::execute(const Config &config, std::size_t l, const Instruction &d) {
+    const bool quirks = config.current_extension == Extension::CHIP8;
+    const bool schip  = !quirks; // SUPER-CHIP opcodes, also part of XO-CHIP
+    uint8_t &vx       = V(d.X, l);
+    uint8_t &vy       = V(d.Y, l);
+    uint8_t &vf       = V(0xF, l);
+    uint16_t &pc      = PC_[l];
+    uint16_t &index   = I_[l];
+
+    switch ((d.opcode >> 12) & 0x0F) {
+        case 0x00:
+            if (d.NN == 0xE0 || d.NNN == 0x230) { // 0230: VIP hires clear
+                display_[l].clear();
+            } else if (d.NN == 0xEE) {
+                assert(sp_[l] > 0 && "Stack underflow");
+                pc = stack_[--sp_[l] * lanes_ + l];
+            } else if (!schip) {
+                break;
+            } else if (d.Y == 0xC && d.X == 0) {
+                display_[l].scroll_down(d.N);
+            } else if (d.NNN == 0x0FB) {
+                display_[l].scroll_right(4);
+            } else if (d.NNN == 0x0FC) {
+                display_[l].scroll_left(4);
+            } else if (d.NNN == 0x0FD) {
+                pc -= 2; // halted; the lane spins here
+            } else if (d.NNN == 0x0FE) {
+                display_[l].resize(LORES_W, LORES_H);
+            } else if (d.NNN == 0x0FF) {
+                display_[l].resize(HIRES_W, HIRES_H);
+            }
+            break;
+        case 0x01: pc = d.NNN; break;
+        case 0x02:
+            assert(sp_[l] < STACK_SIZE && "Stack overflow");
+            stack_[sp_[l]++ * lanes_ + l] = pc;
+            pc                            = d.NNN;
+            break;
+        case 0x03:
+            if (vx == d.NN) pc += 2;
+            break;
+        case 0x04:
+            if (vx != d.NN) pc += 2;
+            break;
+        case 0x05:
+            if (d.N == 0 && vx == vy) pc += 2;
+            break;
+        case 0x06: vx = d.NN; break;
+        case 0x07: vx = static_cast<uint8_t>(vx + d.NN); break;
+        case 0x08: {
+            static constexpr LaneAlu ALU[16] = {
+                LaneAlu::MOV, LaneAlu::OR,   LaneAlu::AND, LaneAlu::XOR, LaneAlu::ADD, LaneAlu::SUB,
+                LaneAlu::SHR, LaneAlu::SUBN, LaneAlu::MOV, LaneAlu::MOV, LaneAlu::MOV, LaneAlu::MOV,
+                LaneAlu::MOV, LaneAlu::MOV,  LaneAlu::SHL, LaneAlu::MOV,
+            };
+            if (d.N > 0x7 && d.N != 0xE) break; // invalid 8XYN
+            lane_alu(ALU[d.N], vx, vy, vf, 0, quirks);
+            break;
+        }
+        case 0x09:
+            if (vx != vy) pc += 2;
+            break;
+        case 0x0A: index = d.NNN; break;
+        case 0x0B:
+            pc = static_cast<uint16_t>(d.NNN + (config.current_extension == Extension::SUPERCHIP ? vx : V(0, l)));
+            break;
+        case 0x0C: {
+            std::uniform_int_distribution<int> rand_byte{ 0, 255 };
+            vx = static_cast<uint8_t>(rand_byte(rng_[l])) & d.NN;
+            break;
+        }
+        case 0x0D: {
+            FrameBuffer &display      = display_[l];
+            const std::size_t width   = display.width();
+            const std::size_t height  = display.height();
+            const std::size_t x_start = vx % width;
+            const std::size_t y_start = vy % height;
+            const bool wide           = d.N == 0 && schip;
+            const uint8_t rows        = wide ? 16 : d.N;
+            const auto &ram           = ram_[l];
+            vf                        = 0;
+
+            for (uint8_t row = 0; row < rows; ++row) {
+                const std::size_t y = y_start + row;
+                if (y >= height) break;
+
+                uint64_t bits;
+                if (wide)
+                    bits = static_cast<uint64_t>(ram[(index + 2 * row) & (RAM_SIZE - 1)]) << 56 |
+                           static_cast<uint64_t>(ram[(index + 2 * row + 1) & (RAM_SIZE - 1)]) << 48;
+                else
+                    bits = static_cast<uint64_t>(ram[(index + row) & (RAM_SIZE - 1)]) << 56;
+                if (display.xor_row(x_start, y, bits)) vf = 1;
+            }
+            break;
+        }
+        case 0x0E: {
+            const bool pressed = (keypad_[l] >> (vx & 0x0F)) & 1;
+            if ((d.NN == 0x9E && pressed) || (d.NN == 0xA1 && !pressed)) pc += 2;
+            break;
+        }
+        case 0x0F:
+            switch (d.NN) {
+                case 0x07: vx = delay_timer_[l]; break;
+                case 0x0A:
+                    if (fx0a_key_[l] == 0xFF) {
+                        // Wait for any key to go down...
+                        for (uint8_t k = 0; k < 16; ++k) {
+                            if ((keypad_[l] >> k) & 1) {
+                                fx0a_key_[l] = k;
+                                break;
+                            }
+                        }
+                        if (fx0a_key_[l] == 0xFF) pc -= 2;
+                    } else if ((keypad_[l] >> fx0a_key_[l]) & 1) {
+                        pc -= 2; // ...then for it to be released
+                    } else {
+                        vx           = fx0a_key_[l];
+                        fx0a_key_[l] = 0xFF;
+                    }
+                    break;
+                case 0x15: delay_timer_[l] = vx; break;
+                case 0x18: sound_timer_[l] = vx; break;
+                case 0x1E: index = static_cast<uint16_t>(index + vx); break;
+                case 0x29: index = static_cast<uint16_t>(vx * 5); break;
+                case 0x30:
+                    if (schip) index = static_cast<uint16_t>(BIG_FONT_START + (vx & 0x0F) * 10);
+                    break;
+                case 0x33: {
+                    uint8_t bcd = vx;
+                    write_ram(l, index + 2, bcd % 10);
+                    bcd /= 10;
+                    write_ram(l, index + 1, bcd % 10);
+                    bcd /= 10;
+                    write_ram(l, index, bcd);
+                    break;
+                }
+                case 0x55:
+                    for (uint8_t i = 0; i <= d.X; ++i) {
+                        if (quirks)
+                            write_ram(l, index++, V(i, l));
+                        else
+                            write_ram(l, static_cast<uint16_t>(index + i), V(i, l));
+                    }
+                    break;
+                case 0x65:
+                    for (uint8_t i = 0; i <= d.X; ++i) {
+                        if (quirks)
+                            V(i, l) = ram_[l][index++ & (RAM_SIZE - 1)];
+                        else
+                            V(i, l) = ram_[l][(index + i) & (RAM_SIZE - 1)];
+                    }
+                    break;
+                case 0x75:
+                    if (schip)
+                        for (uint8_t i = 0; i <= d.X; ++i) rpl_[l][i] = V(i, l);
+                    break;
+                case 0x85:
+                    if (schip)
+                        for (uint8_t i = 0; i <= d.X; ++i) V(i, l) = rpl_[l][i];
+                    break;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group execution through the lane kernels; false if the instruction has no
+// data-parallel form and must be run lane by lane
+// ---------------------------------------------------------------------------
+bool Lockstep::step_group(const Config &config, const Instruction &d) {
+    const bool quirks    = config.current_extension == Extension::CHIP8;
+    const uint8_t *group = group_.data();
+    const LaneKernels &k = kernels_;
+
+    switch ((d.opcode >> 12) & 0x0F) {
+        case 0x01: k.set16(PC_.data(), d.NNN, group, lanes_); return true;
+        case 0x03: k.skip(LaneSkip::EQ_NN, V(d.X), nullptr, d.NN, PC_.data(), group, lanes_); return true;
+        case 0x04: k.skip(LaneSkip::NE_NN, V(d.X), nullptr, d.NN, PC_.data(), group, lanes_); return true;
+        case 0x05:
+            if (d.N == 0) k.skip(LaneSkip::EQ, V(d.X), V(d.Y), 0, PC_.data(), group, lanes_);
+            return true;
+        case 0x06: k.alu(LaneAlu::SET_NN, V(d.X), nullptr, V(0xF), d.NN, quirks, group, lanes_); return true;
+        case 0x07: k.alu(LaneAlu::ADD_NN, V(d.X), nullptr, V(0xF), d.NN, quirks, group, lanes_); return true;
+        case 0x08: {
+            LaneAlu op;
+            switch (d.N) {
+                case 0x0: op = LaneAlu::MOV; break;
+                case 0x1: op = LaneAlu::OR; break;
+                case 0x2: op = LaneAlu::AND; break;
+                case 0x3: op = LaneAlu::XOR; break;
+                case 0x4: op = LaneAlu::ADD; break;
+                case 0x5: op = LaneAlu::SUB; break;
+                case 0x6: op = LaneAlu::SHR; break;
+                case 0x7: op = LaneAlu::SUBN; break;
+                case 0xE: op = LaneAlu::SHL; break;
+                default: return true; // invalid 8XYN: no-op
+            }
+            k.alu(op, V(d.X), V(d.Y), V(0xF), 0, quirks, group, lanes_);
+            return true;
+        }
+        case 0x09: k.skip(LaneSkip::NE, V(d.X), V(d.Y), 0, PC_.data(), group, lanes_); return true;
+        case 0x0A: k.set16(I_.data(), d.NNN, group, lanes_); return true;
+        case 0x0F:
+            switch (d.NN) {
+                case 0x07: k.copy8(V(d.X), delay_timer_.data(), group, lanes_); return true;
+                case 0x15: k.copy8(delay_timer_.data(), V(d.X), group, lanes_); return true;
+                case 0x18: k.copy8(sound_timer_.data(), V(d.X), group, lanes_); return true;
+                case 0x1E: k.add16_u8(I_.data(), V(d.X), group, lanes_); return true;
+                case 0x29: k.digit16(I_.data(), V(d.X), group, lanes_); return true;
+                default: return false;
+            }
+        default: return false;
+    }
+}
+
+void Lockstep::step_lane(const Config &config, std::size_t lane) {
+    const uint16_t pc = PC_[lane];
+    PC_[lane] += 2;
+    execute(config, lane, split(fetch(lane, pc)));
+    ++single_steps_;
+}
+
+void Lockstep::step(const Config &config) {
+    std::fill(pending_.begin(), pending_.end(), 0xFF);
+    std::size_t remaining = lanes_;
+    std::size_t first     = 0; // lowest lane that may still be pending
+
+    // Forming a group costs a pass over every lane, so give up on grouping
+    // once it stops paying off
+    for (int misses = 0; remaining > 0 && misses < MAX_GROUP_MISSES;) {
+        while (!pending_[first]) ++first;
+        const uint16_t pc = PC_[first];
+
+        std::size_t members   = kernels_.match(PC_.data(), pc, pending_.data(), group_.data(), lanes_);
+        const uint16_t opcode = fetch(first, pc);
+
+        // Code some lane has overwritten may differ between lanes: lanes
+        // holding a different opcode go back to pending
+        if (written_[pc & (RAM_SIZE - 1)] || written_[(pc + 1) & (RAM_SIZE - 1)]) {
+            for (std::size_t l = first + 1; l < lanes_; ++l) {
+                if (group_[l] && fetch(l, pc) != opcode) {
+                    group_[l]   = 0;
+                    pending_[l] = 0xFF;
+                    --members;
+                }
+            }
+        }
+        const Instruction inst = split(opcode);
+
+        kernels_.add16(PC_.data(), 2, group_.data(), lanes_);
+        if (!step_group(config, inst)) {
+            for (std::size_t l = first; l < lanes_; ++l)
+                if (group_[l]) execute(config, l, inst);
+        }
+        grouped_steps_ += members;
+        remaining -= members;
+        if (members < MIN_GROUP) ++misses;
+    }
+
+    if (remaining == 0) return;
+    for (std::size_t l = first; l < lanes_; ++l)
+        if (pending_[l]) step_lane(config, l);
+}
+
+void Lockstep::run(const Config &config, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i)
+        step(config);
+}
@@ -0,0 +1,155 @@
+#include "../include/chip8.hpp"
+#include "../include/config.hpp"
+#include "../include/lockstep.hpp"
+#include "../include/scheduler.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+
+// Lockstep runner: emulates one ROM on N lanes at once, each with its own
+// RNG seed and a pseudo-random input stream, and reports lane-instructions
+// per second. With --verify every lane is replayed on a plain Chip8 and the
+// final framebuffers compared.
+
+namespace {
+
+struct LockstepOptions {
+    std::size_t lanes    = 256;
+    uint32_t seed        = 0;
+    uint32_t hold_frames = 0; // 0 = no input, otherwise frames per random key press
+    bool verify          = false;
+};
+
+bool parse_lockstep_args(LockstepOptions &options, int argc, char **argv) {
+    try {
+        for (int i = 2; i + 1 < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) continue;
+            const std::string value = argv[++i];
+            if (arg == "--lanes") options.lanes = std::stoul(value);
+            else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--random-input") options.hold_frames = static_cast<uint32_t>(std::stoul(value));
+            else if (arg == "--verify") options.verify = std::stoul(value) != 0;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+    return options.lanes > 0;
+}
+
+// Key held by `lane` during `frame`, or -1: each lane presses a random key
+// for the first half of every `hold` frames
+int lane_key(uint32_t seed, std::size_t lane, uint64_t frame, uint32_t hold) {
+    if (hold == 0 || frame % hold >= (hold + 1) / 2) return -1;
+    uint64_t z = (uint64_t{ seed } << 32) ^ (lane * 0x9E3779B97F4A7C15ULL) ^ (frame / hold); // splitmix64
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<int>((z ^ (z >> 31)) & 0x0F);
+}
+
+template <typename SetKey>
+void apply_input(SetKey set_key, int key) {
+    for (uint8_t k = 0; k < 16; ++k)
+        set_key(k, k == key);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <rom_path> [--lanes N] [--frames N] [--seed N]"
+                  << " [--random-input FRAMES] [--verify 1] [options]\n";
+        return EXIT_FAILURE;
+    }
+
+    Config config;
+    LockstepOptions options;
+    if (!set_config_from_args(config, argc, argv) || !parse_lockstep_args(options, argc, argv))
+        return EXIT_FAILURE;
+    if (config.max_frames == 0) config.max_frames = 600;
+    if (config.current_extension == Extension::XOCHIP) {
+        std::cerr << "Error: the lockstep engine does not support XO-CHIP.\n";
+        return EXIT_FAILURE;
+    }
+    if (dialect(config).quirks != default_quirks(config.current_extension)) {
+        std::cerr << "Error: the lockstep engine does not support --quirks.\n";
+        return EXIT_FAILURE;
+    }
+
+    Lockstep machines(argv[1], options.lanes);
+    if (!machines.loaded()) return EXIT_FAILURE;
+    for (std::size_t l = 0; l < options.lanes; ++l)
+        machines.seed_rng(l, options.seed + static_cast<uint32_t>(l));
+
+    Scheduler scheduler(config.insts_per_second);
+    uint64_t instructions = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t frame = 0; frame < config.max_frames; ++frame) {
+        if (options.hold_frames != 0) {
+            for (std::size_t l = 0; l < options.lanes; ++l)
+                apply_input([&](uint8_t k, bool down) { machines.set_key(l, k, down); },
+                            lane_key(options.seed, l, frame, options.hold_frames));
+        }
+        const uint32_t batch = scheduler.instructions_for_frame();
+        machines.run(config, batch);
+        instructions += batch;
+        machines.update_timers();
+    }
+    const auto end         = std::chrono::steady_clock::now();
+    const double elapsed_s = std::chrono::duration<double>(end - start).count();
+
+    const uint64_t lane_instructions = instructions * options.lanes;
+    const double lips                = elapsed_s > 0.0 ? static_cast<double>(lane_instructions) / elapsed_s : 0.0;
+    const double grouped             = 100.0 * static_cast<double>(machines.grouped_steps()) /
+                           static_cast<double>(machines.grouped_steps() + machines.single_steps());
+
+    std::unordered_set<uint64_t> distinct;
+    for (std::size_t l = 0; l < options.lanes; ++l)
+        distinct.insert(machines.display_hash(l));
+
+    std::cout << "ROM:               " << argv[1] << '\n'
+              << "Lanes:             " << options.lanes << " (" << machines.kernels_name() << " kernels)\n"
+              << "Frames:            " << config.max_frames << '\n'
+              << "Lane-instructions: " << lane_instructions << '\n'
+              << std::fixed << std::setprecision(3)
+              << "Elapsed:           " << elapsed_s * 1000.0 << " ms\n"
+              << std::setprecision(0)
+              << "Throughput:        " << lips << " lane-instructions/s\n"
+              << std::setprecision(1)
+              << "Grouped:           " << grouped << "% of lane-instructions\n"
+              << "Distinct displays: " << distinct.size() << '\n';
+
+    if (!options.verify) return EXIT_SUCCESS;
+
+    // Reference: the same lanes one after another on the ordinary core
+    std::size_t mismatches = 0;
+    const auto ref_start   = std::chrono::steady_clock::now();
+    for (std::size_t l = 0; l < options.lanes; ++l) {
+        Chip8 chip8(argv[1]);
+        chip8.seed_rng(options.seed + static_cast<uint32_t>(l));
+        Scheduler ref_scheduler(config.insts_per_second);
+        for (uint64_t frame = 0; frame < config.max_frames; ++frame) {
+            if (options.hold_frames != 0)
+                apply_input([&](uint8_t k, bool down) { chip8.set_key(k, down); },
+                            lane_key(options.seed, l, frame, options.hold_frames));
+            chip8.run(config, ref_scheduler.instructions_for_frame());
+            chip8.update_timers();
+        }
+        if (chip8.display_hash() != machines.display_hash(l)) {
+            if (mismatches++ < 8) std::cout << "Mismatch on lane " << l << '\n';
+        }
+    }
+    const double ref_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - ref_start).count();
+
+    std::cout << std::setprecision(3)
+              << "Reference:         " << ref_s * 1000.0 << " ms on Chip8 ("
+              << std::setprecision(2) << (elapsed_s > 0.0 ? ref_s / elapsed_s : 0.0) << "x)\n"
+              << "Verify:            " << (mismatches == 0 ? "OK" : "FAILED") << " (" << mismatches << " mismatches)\n";
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
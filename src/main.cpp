@@ -1,11 +1,28 @@
+#include "../include/audio.hpp"
 #include "../include/chip8.hpp"
 #include "../include/display.hpp"
-#include <SDL2/SDL_timer.h>
+#include "../include/input.hpp"
+#include "../include/movie.hpp"
+#include "../include/perf.hpp"
+#include "../include/rewind.hpp"
+#include "../include/rom_library.hpp"
+#include "../include/run_ahead.hpp"
+#include "../include/scheduler.hpp"
+#include "../include/triple_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 int main(int argc, char **argv) {
     if (argc < 2) {
@@ -19,37 +36,245 @@ int main(int argc, char **argv) {
     if (!set_config_from_args(config, argc, argv))
         return EXIT_FAILURE;
 
+    RomLibrary library;
+    if (!config.rom_db_path.empty() && !library.load_database(config.rom_db_path))
+        return EXIT_FAILURE;
+    const std::shared_ptr<const RomImage> rom = library.open(argv[1]);
+    if (!rom || !library.configure(config, *rom, argc, argv))
+        return EXIT_FAILURE;
+
+    const RomSettings settings = library.settings(*rom);
+    if (!settings.title.empty()) std::cout << "Title: " << settings.title << '\n';
+    if (!settings.keys.empty()) std::cout << "Keys:  " << settings.keys << '\n';
+
     Audio audio(config);
     Display display(config);
-    Chip8 chip8(argv[1], audio);
+    Chip8 chip8(rom);
+    Scheduler scheduler(config.insts_per_second);
 
     display.clear_screen(config);
 
-    while (chip8.get_state() != EmulatorState::QUIT) {
-        chip8.handle_input(config);
+    // The core runs on its own thread, paced by the scheduler. This thread
+    // handles SDL events and draws; it always shows the newest complete frame
+    // and passes input over, so a slow present never delays emulation.
+    // The emulation thread owns `core_config`; this one keeps `config`.
+    Config core_config = config;
+    TripleBuffer<FrameBuffer> frames;
+    InputQueue input;
+    std::atomic<bool> emulating{ true };
 
-        if (chip8.get_state() == EmulatorState::PAUSED)
-            continue;
+    // This thread's counters, folded into the core's when they are written
+    std::atomic<uint64_t> frames_shown{ 0 }, render_ns{ 0 }, present_ns{ 0 };
+
+    std::thread emulation([&]() {
+        std::vector<int16_t> audio_frame(core_config.audio_sample_rate / 60 + 1);
+
+        // Save slot next to the ROM, plus per-frame history for rewinding
+        const std::string state_path = std::string(argv[1]) + ".state";
+        RewindBuffer rewind;
+        SaveState state;
 
-        const uint64_t frame_start = SDL_GetPerformanceCounter();
+        // Movie recording needs a known seed, so pick one if none was given
+        if (core_config.seed < 0 && !core_config.record_path.empty()) core_config.seed = std::random_device{}();
+        if (core_config.seed >= 0) chip8.seed_rng(static_cast<uint32_t>(core_config.seed));
 
-        for (uint32_t i = 0; i < config.insts_per_second / 60; ++i)
-            chip8.emulate_instruction(config);
+        Movie movie;
+        bool recording = !core_config.record_path.empty();
+        if (recording) movie.start(chip8.rom_hash(), static_cast<uint32_t>(core_config.seed), core_config);
+        uint64_t frame = 0;
 
-        const uint64_t frame_end = SDL_GetPerformanceCounter();
-        const double elapsed_ms  = static_cast<double>(frame_end - frame_start) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+        // A movie only replays from power-on, so anything that jumps the
+        // machine elsewhere ends the recording
+        auto stop_recording = [&]() {
+            if (!recording) return;
+            recording = false;
+            movie.finish(frame, chip8.display_hash());
+            if (movie.save(core_config.record_path))
+                std::cout << "Recorded " << frame << " frames to " << core_config.record_path << '\n';
+        };
 
-        const double target_ms = 1000.0 / 60.0; // ~16.67 ms
-        if (target_ms > elapsed_ms)
-            SDL_Delay(static_cast<uint32_t>(target_ms - elapsed_ms));
+        // Counters go to the --profile file at exit, or on F2 to that file
+        // or next to the ROM
+        PerfCounters &perf          = chip8.perf();
+        const std::string perf_path = core_config.profile_path.empty() ? std::string(argv[1]) + ".perf.json"
+                                                                       : core_config.profile_path;
+        auto dump_perf = [&]() {
+            perf.audio_underruns = audio.underruns();
+            perf.frames          = frames_shown.load(std::memory_order_relaxed);
+            perf.stage_ns[static_cast<std::size_t>(Stage::RENDER)]  = render_ns.load(std::memory_order_relaxed);
+            perf.stage_ns[static_cast<std::size_t>(Stage::PRESENT)] = present_ns.load(std::memory_order_relaxed);
+            if (save_perf_json(perf_path, chip8.perf(), chip8.pc_profile()))
+                std::cout << "Wrote performance counters to " << perf_path << '\n';
+        };
 
-        if (chip8.get_draw_flag()) {
-            display.update_screen(config, chip8);
+        // Hands the core's display to the drawing thread if it changed
+        auto publish = [&]() {
+            if (!chip8.get_draw_flag()) return;
+            frames.back() = chip8.get_display();
+            frames.publish();
             chip8.set_draw_flag(false);
+            chip8.clear_dirty_rows();
+        };
+
+        // Execution trace: from startup with --trace, toggled with F3 (to
+        // the --trace file or next to the ROM)
+        Tracer tracer;
+        const std::string trace_path = core_config.trace_path.empty() ? std::string(argv[1]) + ".trace"
+                                                                      : core_config.trace_path;
+        auto toggle_trace = [&]() {
+            if (tracer.active()) {
+                chip8.set_tracer(nullptr);
+                tracer.stop();
+                std::cout << "Trace stopped: " << tracer.written() << " records written to " << trace_path << ", "
+                          << tracer.dropped() << " dropped\n";
+            } else if (tracer.start(trace_path, chip8.rom_hash())) {
+                chip8.set_tracer(&tracer);
+                std::cout << "Tracing to " << trace_path << '\n';
+            }
+        };
+        if (!core_config.trace_path.empty()) toggle_trace();
+
+        // Speculative frames would land in profiles and traces, so run-ahead
+        // sits out while either is on
+        RunAhead run_ahead(core_config.run_ahead);
+
+        InputActions actions;
+        InputMessage message;
+        bool was_paused = false;
+        while (chip8.get_state() != EmulatorState::QUIT) {
+            while (input.pop(message)) apply_input(message, chip8, core_config, actions);
+
+            if (actions.reset) {
+                stop_recording();
+                chip8.reset();
+                rewind.clear();
+                actions.reset = false;
+            }
+
+            if (actions.dump_perf) {
+                dump_perf();
+                actions.dump_perf = false;
+            }
+            if (actions.toggle_trace) {
+                toggle_trace();
+                actions.toggle_trace = false;
+            }
+            if (actions.save_state) {
+                chip8.save_state(state);
+                if (write_save_state(state_path, state)) std::cout << "Saved state to " << state_path << '\n';
+                actions.save_state = false;
+            }
+            if (actions.load_state) {
+                if (read_save_state(state_path, state)) {
+                    stop_recording();
+                    chip8.load_state(state);
+                    rewind.clear();
+                    std::cout << "Loaded state from " << state_path << '\n';
+                }
+                actions.load_state = false;
+            }
+
+            if (chip8.get_state() == EmulatorState::PAUSED) {
+                StageTimer timer(perf, Stage::SLEEP);
+                scheduler.wait_for_next_frame();
+                was_paused = true;
+                continue;
+            }
+            if (was_paused) {
+                scheduler.restart(); // don't try to catch up on the paused time
+                was_paused = false;
+            }
+
+            // Rewinding replays history backwards one frame per frame, silently
+            if (actions.rewinding) {
+                if (rewind.step_back(state)) {
+                    stop_recording();
+                    chip8.load_state(state);
+                }
+                publish();
+                std::fill(audio_frame.begin(), audio_frame.end(), int16_t{ 0 });
+                audio.push(audio_frame.data(), core_config.audio_sample_rate / 60);
+                StageTimer timer(perf, Stage::SLEEP);
+                scheduler.wait_for_next_frame();
+                continue;
+            }
+
+            // One frame of emulated time: the CPU's share of instructions,
+            // then exactly one 60 Hz timer tick
+            if (recording) movie.record_frame(frame, chip8.keypad_mask());
+            {
+                StageTimer timer(perf, Stage::EXECUTE);
+                chip8.run(core_config, scheduler.instructions_for_frame());
+            }
+
+            const bool ahead = run_ahead.enabled() && !tracer.active() && core_config.profile_path.empty();
+            if (!ahead) publish();
+
+            chip8.update_timers();
+            audio.push(audio_frame.data(),
+                       chip8.render_audio(core_config, audio_frame.data(), audio_frame.size()));
+
+            chip8.save_state(state);
+            rewind.push(state);
+
+            // Show the screen run_ahead.frames() frames on, then go back
+            if (ahead) {
+                run_ahead.speculate(chip8, core_config, scheduler);
+                publish();
+                run_ahead.restore(chip8, state);
+            }
+
+            frame++;
+            StageTimer timer(perf, Stage::SLEEP);
+            scheduler.wait_for_next_frame();
+        }
+        stop_recording();
+        if (!core_config.profile_path.empty()) dump_perf();
+        if (tracer.active()) toggle_trace();
+
+        if (run_ahead.enabled() && frame > 0)
+            std::cout << std::fixed << std::setprecision(1) << "Run-ahead: " << run_ahead.frames() << " frames, "
+                      << static_cast<double>(perf.stage_ns[static_cast<std::size_t>(Stage::RUN_AHEAD)]) / 1e3 /
+                             static_cast<double>(frame)
+                      << " us per frame\n";
+        emulating.store(false, std::memory_order_release);
+    });
+
+    // Draw whatever frame is newest; with nothing new, wait a millisecond so
+    // input is still picked up promptly
+    PerfCounters ui_perf;
+    FrameBuffer shown; // on screen; assign() marks the rows a new frame changed
+    while (emulating.load(std::memory_order_acquire)) {
+        handle_input(input, config);
+
+        if (!frames.update()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
         }
+        shown.assign(frames.front());
+        {
+            StageTimer timer(ui_perf, Stage::RENDER);
+            display.update_screen(config, shown);
+        }
+        {
+            StageTimer timer(ui_perf, Stage::PRESENT);
+            display.present();
+        }
+        shown.clear_dirty();
 
-        chip8.update_timers();
+        ui_perf.frames++;
+        frames_shown.store(ui_perf.frames, std::memory_order_relaxed);
+        render_ns.store(ui_perf.stage_ns[static_cast<std::size_t>(Stage::RENDER)], std::memory_order_relaxed);
+        present_ns.store(ui_perf.stage_ns[static_cast<std::size_t>(Stage::PRESENT)], std::memory_order_relaxed);
     }
+    emulation.join();
+
+    const FrameStats stats = scheduler.stats();
+    std::cout << std::fixed << std::setprecision(1)
+              << "Frame pacing: " << stats.frames << " frames, jitter mean "
+              << stats.mean_jitter_us << " us, stddev " << stats.stddev_jitter_us
+              << " us, max " << stats.max_jitter_us << " us, " << stats.overruns << " overruns, "
+              << audio.underruns() << " audio underruns, " << ui_perf.frames << " frames presented\n";
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,86 @@
+#include "../include/movie.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+void Movie::start(uint64_t rom_hash, uint32_t seed, const Config &config) {
+    header_                  = MovieHeader{};
+    header_.extension        = static_cast<uint8_t>(config.current_extension);
+    header_.quirks           = dialect(config).quirks;
+    header_.seed             = seed;
+    header_.insts_per_second = config.insts_per_second;
+    header_.rom_hash         = rom_hash;
+    input_                   = InputScript{};
+    keypad_                  = 0;
+}
+
+void Movie::record_frame(uint64_t frame, uint16_t keypad) {
+    const uint16_t changed = keypad ^ keypad_;
+    if (changed == 0) return;
+
+    for (uint8_t k = 0; k < 16; ++k)
+        if ((changed >> k) & 1) input_.add({ frame, k, ((keypad >> k) & 1) != 0 });
+    keypad_ = keypad;
+}
+
+void Movie::finish(uint64_t frames, uint64_t final_hash) {
+    header_.frames      = frames;
+    header_.final_hash  = final_hash;
+    header_.event_count = input_.events().size();
+}
+
+void Movie::apply_settings(Config &config) const {
+    config.current_extension = static_cast<Extension>(header_.extension);
+    config.quirks_on         = static_cast<uint8_t>(header_.quirks & ~default_quirks(config.current_extension));
+    config.quirks_off        = static_cast<uint8_t>(~header_.quirks & default_quirks(config.current_extension));
+    config.insts_per_second  = header_.insts_per_second;
+    config.seed              = header_.seed;
+    config.max_frames        = header_.frames;
+}
+
+bool Movie::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+    for (const InputEvent &e : input_.events()) {
+        MovieEvent event;
+        event.frame   = static_cast<uint32_t>(e.frame);
+        event.key     = e.key;
+        event.pressed = e.pressed ? 1 : 0;
+        file.write(reinterpret_cast<const char *>(&event), sizeof(event));
+    }
+    if (!file) {
+        std::cerr << "Error: cannot write movie \"" << path << "\".\n";
+        return false;
+    }
+    return true;
+}
+
+bool Movie::load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    MovieHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        std::cerr << "Error: cannot read movie \"" << path << "\".\n";
+        return false;
+    }
+    if (header.magic != MovieHeader::MAGIC || header.version < 1 || header.version > MovieHeader::VERSION) {
+        std::cerr << "Error: \"" << path << "\" is not a version 1-" << MovieHeader::VERSION << " movie.\n";
+        return false;
+    }
+    if (header.version == 1) header.quirks = default_quirks(static_cast<Extension>(header.extension));
+
+    InputScript input;
+    for (uint64_t i = 0; i < header.event_count; ++i) {
+        MovieEvent event;
+        if (!file.read(reinterpret_cast<char *>(&event), sizeof(event)) || event.key > 0x0F) {
+            std::cerr << "Error: movie \"" << path << "\" is truncated or corrupt.\n";
+            return false;
+        }
+        input.add({ event.frame, event.key, event.pressed != 0 });
+    }
+
+    header_ = header;
+    input_  = std::move(input);
+    keypad_ = 0;
+    return true;
+}
@@ -0,0 +1,62 @@
+#include "../include/perf.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+uint64_t PerfCounters::instructions() const {
+    return std::accumulate(op_class.begin(), op_class.end(), uint64_t{ 0 });
+}
+
+void write_perf_json(std::ostream &out, const PerfCounters &perf, const std::vector<uint64_t> &pc_profile) {
+    static constexpr const char *STAGE_NAMES[] = { "execute", "run_ahead", "render", "present", "sleep" };
+    static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<std::size_t>(Stage::COUNT),
+                  "one name per stage");
+
+    const auto flags = out.flags();
+    const char fill  = out.fill();
+    out << "{\n  \"instructions\": " << perf.instructions() << ",\n  \"op_class\": {";
+    for (std::size_t c = 0; c < perf.op_class.size(); ++c)
+        out << (c ? ", " : " ") << '"' << std::uppercase << std::hex << c << "xxx\": " << std::dec
+            << perf.op_class[c];
+    out << " },\n"
+        << "  \"draws\": " << perf.draws << ",\n"
+        << "  \"sprite_rows\": " << perf.sprite_rows << ",\n"
+        << "  \"collisions\": " << perf.collisions << ",\n"
+        << "  \"idle_instructions\": " << perf.idle_instructions << ",\n"
+        << "  \"frames\": " << perf.frames << ",\n"
+        << "  \"audio_underruns\": " << perf.audio_underruns << ",\n"
+        << "  \"stage_ms\": {" << std::fixed << std::setprecision(3);
+    for (std::size_t s = 0; s < perf.stage_ns.size(); ++s)
+        out << (s ? ", " : " ") << '"' << STAGE_NAMES[s] << "\": " << static_cast<double>(perf.stage_ns[s]) / 1e6;
+    out << " }";
+
+    if (!pc_profile.empty()) {
+        std::vector<uint16_t> hot;
+        for (std::size_t pc = 0; pc < pc_profile.size(); ++pc)
+            if (pc_profile[pc] != 0) hot.push_back(static_cast<uint16_t>(pc));
+        std::stable_sort(hot.begin(), hot.end(),
+                         [&](uint16_t a, uint16_t b) { return pc_profile[a] > pc_profile[b]; });
+
+        out << ",\n  \"hot_pcs\": [";
+        for (std::size_t i = 0; i < hot.size(); ++i)
+            out << (i ? "," : "") << "\n    { \"pc\": \"0x" << std::uppercase << std::hex << std::setw(3)
+                << std::setfill('0') << hot[i] << "\", \"count\": " << std::dec << pc_profile[hot[i]] << " }";
+        out << "\n  ]";
+    }
+    out << "\n}\n";
+    out.flags(flags);
+    out.fill(fill);
+}
+
+bool save_perf_json(const std::string &path, const PerfCounters &perf, const std::vector<uint64_t> &pc_profile) {
+    std::ofstream file(path, std::ios::trunc);
+    write_perf_json(file, perf, pc_profile);
+    if (!file) {
+        std::cerr << "Error: cannot write performance counters to \"" << path << "\".\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,114 @@
+#include "../include/rewind.hpp"
+
+#include <cstring>
+
+// Delta layout: uint32 run count, then per run a uint16 first word, a uint16
+// word count and the words themselves (the older state's values)
+static constexpr std::size_t STATE_WORDS = sizeof(SaveState) / 8;
+
+static inline uint64_t load_word(const uint8_t *base, std::size_t word) {
+    uint64_t value;
+    std::memcpy(&value, base + word * 8, 8);
+    return value;
+}
+
+template <typename T>
+static inline void append(std::vector<uint8_t> &out, T value) {
+    const std::size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(&out[at], &value, sizeof(T));
+}
+
+RewindBuffer::RewindBuffer(std::size_t capacity_bytes)
+    : arena_(capacity_bytes) {
+    scratch_.reserve(sizeof(SaveState) * 2);
+}
+
+void RewindBuffer::push(const SaveState &state) {
+    if (!has_newest_) {
+        newest_     = state;
+        has_newest_ = true;
+        return;
+    }
+
+    // Backward delta: the words of the current newest state that `state` changes
+    const uint8_t *older = reinterpret_cast<const uint8_t *>(&newest_);
+    const uint8_t *newer = reinterpret_cast<const uint8_t *>(&state);
+    scratch_.clear();
+    append<uint32_t>(scratch_, 0);
+
+    uint32_t runs = 0;
+    for (std::size_t w = 0; w < STATE_WORDS;) {
+        if (load_word(older, w) == load_word(newer, w)) {
+            ++w;
+            continue;
+        }
+        std::size_t end = w + 1;
+        while (end < STATE_WORDS && load_word(older, end) != load_word(newer, end)) ++end;
+
+        append(scratch_, static_cast<uint16_t>(w));
+        append(scratch_, static_cast<uint16_t>(end - w));
+        const std::size_t at = scratch_.size();
+        scratch_.resize(at + (end - w) * 8);
+        std::memcpy(&scratch_[at], older + w * 8, (end - w) * 8);
+        ++runs;
+        w = end;
+    }
+    std::memcpy(scratch_.data(), &runs, sizeof(runs));
+    newest_ = state;
+
+    // Claim space in the ring, evicting the oldest deltas it overlaps
+    const std::size_t size = scratch_.size();
+    if (size > arena_.size()) {
+        entries_.clear(); // no room for even one step back
+        head_ = 0;
+        return;
+    }
+    if (head_ + size > arena_.size()) {
+        // Everything past the write position is older than what precedes it
+        while (!entries_.empty() && entries_.front().offset >= head_) entries_.pop_front();
+        head_ = 0;
+    }
+    while (!entries_.empty() && entries_.front().offset >= head_ && entries_.front().offset < head_ + size)
+        entries_.pop_front();
+
+    std::memcpy(&arena_[head_], scratch_.data(), size);
+    entries_.push_back({ head_, size });
+    head_ += size;
+}
+
+bool RewindBuffer::step_back(SaveState &state) {
+    if (!has_newest_ || entries_.empty()) return false;
+
+    const Entry entry = entries_.back();
+    entries_.pop_back();
+    head_ = entry.offset;
+
+    const uint8_t *delta = &arena_[entry.offset];
+    uint8_t *target      = reinterpret_cast<uint8_t *>(&newest_);
+    uint32_t runs;
+    std::memcpy(&runs, delta, sizeof(runs));
+    delta += sizeof(runs);
+    for (uint32_t r = 0; r < runs; ++r) {
+        uint16_t first, count;
+        std::memcpy(&first, delta, sizeof(first));
+        std::memcpy(&count, delta + 2, sizeof(count));
+        std::memcpy(target + first * 8, delta + 4, count * 8u);
+        delta += 4 + count * 8u;
+    }
+
+    state = newest_;
+    return true;
+}
+
+void RewindBuffer::clear() {
+    entries_.clear();
+    head_       = 0;
+    has_newest_ = false;
+}
+
+std::size_t RewindBuffer::bytes_used() const {
+    std::size_t total = 0;
+    for (const Entry &entry : entries_) total += entry.size;
+    return total;
+}
@@ -0,0 +1,217 @@
+#include "../include/rom_library.hpp"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHIP8_ROM_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CHIP8_ROM_MMAP 0
+#endif
+
+// ---------------------------------------------------------------------------
+// ROM images
+// ---------------------------------------------------------------------------
+std::shared_ptr<const RomImage> RomImage::open(const std::string &path) {
+    std::shared_ptr<RomImage> image(new RomImage);
+    image->path_ = path;
+
+#if CHIP8_ROM_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info {};
+    if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        if (fd >= 0) ::close(fd);
+        std::cerr << "Error: ROM \"" << path << "\" is invalid or does not exist.\n";
+        return nullptr;
+    }
+    image->size_ = static_cast<std::size_t>(info.st_size);
+    if (image->size_ > 0) {
+        void *mem = mmap(nullptr, image->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem != MAP_FAILED) {
+            image->mapping_ = mem;
+            image->data_    = static_cast<const uint8_t *>(mem);
+        }
+    }
+    ::close(fd);
+#endif
+
+    // No mmap on this host, or it failed (or the file is empty): read it instead
+    if (!image->data_) {
+        std::ifstream rom(path, std::ios::binary);
+        if (!rom) {
+            std::cerr << "Error: ROM \"" << path << "\" is invalid or does not exist.\n";
+            return nullptr;
+        }
+        image->buffer_.assign(std::istreambuf_iterator<char>(rom), std::istreambuf_iterator<char>());
+        image->data_ = image->buffer_.data();
+        image->size_ = image->buffer_.size();
+    }
+
+    image->hash_ = 0xCBF29CE484222325ULL;
+    for (std::size_t i = 0; i < image->size_; ++i) {
+        image->hash_ ^= image->data_[i];
+        image->hash_ *= 0x100000001B3ULL;
+    }
+    return image;
+}
+
+RomImage::~RomImage() {
+#if CHIP8_ROM_MMAP
+    if (mapping_) munmap(mapping_, size_);
+#endif
+}
+
+void RomSettings::apply(Config &config) const {
+    if (extension >= 0) config.current_extension = static_cast<Extension>(extension);
+    config.quirks_on  = static_cast<uint8_t>((config.quirks_on & ~quirks_off) | quirks_on);
+    config.quirks_off = static_cast<uint8_t>((config.quirks_off & ~quirks_on) | quirks_off);
+    if (insts_per_second != 0) config.insts_per_second = insts_per_second;
+}
+
+// ---------------------------------------------------------------------------
+// Library
+// ---------------------------------------------------------------------------
+namespace {
+
+std::string trim(const std::string &s) {
+    const std::size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return {};
+    return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+// A "quoted string" with \" and \\ escapes; `rest` gets what follows it
+bool parse_string(const std::string &value, std::string &out, std::string &rest) {
+    if (value.empty() || value[0] != '"') return false;
+    out.clear();
+    for (std::size_t i = 1; i < value.size(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            out += value[++i];
+        } else if (value[i] == '"') {
+            rest = value.substr(i + 1);
+            return true;
+        } else {
+            out += value[i];
+        }
+    }
+    return false; // unterminated
+}
+
+// A whole value that is one string, optionally followed by a comment
+bool parse_string_value(const std::string &value, std::string &out) {
+    std::string rest;
+    if (!parse_string(value, out, rest)) return false;
+    rest = trim(rest);
+    return rest.empty() || rest.front() == '#';
+}
+
+} // namespace
+
+bool RomLibrary::load_database(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: ROM database \"" << path << "\" cannot be opened.\n";
+        return false;
+    }
+
+    RomSettings *entry = nullptr;
+    std::string line;
+    for (std::size_t line_no = 1; std::getline(file, line); ++line_no) {
+        const auto fail = [&](const char *what) {
+            std::cerr << "Error: " << path << ":" << line_no << ": " << what << '\n';
+            return false;
+        };
+
+        // A # before any string starts a comment; one after a string value
+        // is dealt with once the string has been parsed
+        std::string text = line;
+        const std::size_t quote = text.find('"');
+        const std::size_t hash  = text.find('#');
+        if (hash != std::string::npos && (quote == std::string::npos || hash < quote)) text.erase(hash);
+        text = trim(text);
+        if (text.empty()) continue;
+
+        if (text.front() == '[') {
+            if (text.back() != ']' || text.size() != 18) return fail("expected `[<16 hex digits>]`");
+            for (std::size_t i = 1; i < 17; ++i)
+                if (!std::isxdigit(static_cast<unsigned char>(text[i]))) return fail("expected `[<16 hex digits>]`");
+            entry = &database_[std::stoull(text.substr(1, 16), nullptr, 16)];
+            continue;
+        }
+
+        const std::size_t eq = text.find('=');
+        if (eq == std::string::npos) return fail("expected `key = value`");
+        if (!entry) return fail("setting outside a [hash] table");
+        const std::string key   = trim(text.substr(0, eq));
+        const std::string value = trim(text.substr(eq + 1));
+
+        if (key == "title" || key == "keys") {
+            std::string str;
+            if (!parse_string_value(value, str)) return fail("expected a \"string\"");
+            (key == "title" ? entry->title : entry->keys) = str;
+        } else if (key == "quirks") {
+            std::string str;
+            if (!parse_string_value(value, str)) return fail("expected a \"string\"");
+            if (!parse_quirks(str, entry->quirks_on, entry->quirks_off)) return fail("unknown quirk");
+        } else if (key == "extension" || key == "insts_per_second") {
+            std::size_t used = 0;
+            unsigned long number = 0;
+            try {
+                number = std::stoul(value, &used);
+            } catch (const std::exception &) {
+            }
+            if (used == 0 || used != value.size()) return fail("expected a number");
+            if (key == "extension") {
+                if (number > Extension::XOCHIP) return fail("extension must be 0, 1 or 2");
+                entry->extension = static_cast<int>(number);
+            } else {
+                entry->insts_per_second = static_cast<uint32_t>(number);
+            }
+        } else {
+            return fail("unknown setting");
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const RomImage> RomLibrary::open(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const auto it = images_.find(path); it != images_.end()) return it->second;
+    }
+
+    // Open outside the lock; if two threads race, the first one stored wins
+    std::shared_ptr<const RomImage> image = RomImage::open(path);
+    if (!image) return nullptr;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return images_.emplace(path, std::move(image)).first->second;
+}
+
+bool RomLibrary::configure(Config &config, const RomImage &rom, int argc, char **argv) const {
+    config = Config{};
+    settings(rom).apply(config);
+    return set_config_from_args(config, argc, argv);
+}
+
+RomSettings RomLibrary::settings(const RomImage &rom) const {
+    RomSettings settings;
+    if (const auto it = database_.find(rom.hash()); it != database_.end()) settings = it->second;
+    if (!settings.keys.empty()) return settings;
+
+    std::filesystem::path sidecar(rom.path());
+    sidecar.replace_extension(".txt");
+    std::ifstream file(sidecar);
+    if (file) {
+        std::ostringstream text;
+        text << file.rdbuf();
+        settings.keys = trim(text.str());
+    }
+    return settings;
+}
@@ -0,0 +1,40 @@
+#include "../include/run_ahead.hpp"
+
+#include <chrono>
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+void RunAhead::speculate(Chip8 &chip8, const Config &config, const Scheduler &scheduler) {
+    const auto start = std::chrono::steady_clock::now();
+    saved_           = chip8.perf();
+
+    // Same frame shape as the real loop: the frame's instructions, then one
+    // timer tick. A speculative 00FD still quits, only a little early.
+    Scheduler ahead = scheduler;
+    for (uint32_t f = 0; f < frames_ && chip8.get_state() == EmulatorState::RUNNING; ++f) {
+        chip8.run(config, ahead.instructions_for_frame());
+        chip8.update_timers();
+    }
+
+    // Only the real frames count as work; the speculation is host time
+    PerfCounters &perf = chip8.perf();
+    perf               = saved_;
+    last_ns_           = elapsed_ns(start);
+    perf.stage_ns[static_cast<std::size_t>(Stage::RUN_AHEAD)] += last_ns_;
+}
+
+void RunAhead::restore(Chip8 &chip8, const SaveState &now) {
+    const auto start = std::chrono::steady_clock::now();
+    chip8.load_state(now);
+
+    const uint64_t ns = elapsed_ns(start);
+    last_ns_ += ns;
+    chip8.perf().stage_ns[static_cast<std::size_t>(Stage::RUN_AHEAD)] += ns;
+}
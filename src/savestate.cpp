@@ -0,0 +1,58 @@
+#include "../include/savestate.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// A bool's object representation, which may be neither 0 nor 1 in a file
+bool is_bool(const bool &b) {
+    uint8_t byte;
+    std::memcpy(&byte, &b, 1);
+    return byte <= 1;
+}
+
+} // namespace
+
+bool SaveState::valid() const {
+    const std::size_t width = display.width(), height = display.height();
+    if ((width != 64 && width != 128) || (height != 32 && height != 64) || display.words_per_row() != width / 64)
+        return false;
+    if (sp > stack.size() || planes > FrameBuffer::ALL_PLANES) return false;
+    if (!is_bool(fx0a_waiting) || !is_bool(beeping) || !is_bool(audio_pattern_set)) return false;
+    for (const bool &key : keypad)
+        if (!is_bool(key)) return false;
+    return !fx0a_waiting || fx0a_key < keypad.size();
+}
+
+bool write_save_state(const std::string &path, const SaveState &state) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char *>(&state), sizeof(state))) {
+        std::cerr << "Error: cannot write save state \"" << path << "\".\n";
+        return false;
+    }
+    return true;
+}
+
+bool read_save_state(const std::string &path, SaveState &state) {
+    std::ifstream file(path, std::ios::binary);
+    SaveState loaded;
+    if (!file.read(reinterpret_cast<char *>(&loaded), sizeof(loaded))) {
+        std::cerr << "Error: cannot read save state \"" << path << "\".\n";
+        return false;
+    }
+    if (loaded.magic != SaveState::MAGIC || loaded.version != SaveState::VERSION ||
+        loaded.size != sizeof(SaveState)) {
+        std::cerr << "Error: \"" << path << "\" is not a save state for this build (version "
+                  << loaded.version << ", " << loaded.size << " bytes).\n";
+        return false;
+    }
+    if (!loaded.valid()) {
+        std::cerr << "Error: \"" << path << "\" is a corrupt save state.\n";
+        return false;
+    }
+    state = loaded;
+    return true;
+}
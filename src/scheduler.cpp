@@ -0,0 +1,54 @@
+#include "../include/scheduler.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+static constexpr std::chrono::nanoseconds FRAME_PERIOD{ 1000000000 / Scheduler::FRAME_HZ };
+
+// OS sleeps commonly overshoot by up to a millisecond or so; sleep until
+// this close to the deadline, then spin the rest.
+static constexpr std::chrono::microseconds SPIN_MARGIN{ 1500 };
+
+void Scheduler::restart() {
+    deadline_ = Clock::now() + FRAME_PERIOD;
+}
+
+void Scheduler::wait_for_next_frame() {
+    const auto now = Clock::now();
+    if (deadline_ - now > SPIN_MARGIN)
+        std::this_thread::sleep_for(deadline_ - now - SPIN_MARGIN);
+    while (Clock::now() < deadline_)
+        std::this_thread::yield();
+
+    const auto woke    = Clock::now();
+    const double error = std::chrono::duration<double, std::micro>(woke - deadline_).count();
+
+    ++frames_;
+    sum_us_ += error;
+    sum_sq_us_ += error * error;
+    if (error > max_us_) max_us_ = error;
+
+    // Deadlines are absolute so a slow frame is made up by a shorter wait
+    // next time. If we fell more than a frame behind, drop the backlog
+    // instead of fast-forwarding through it.
+    deadline_ += FRAME_PERIOD;
+    if (woke > deadline_) {
+        ++overruns_;
+        deadline_ = woke + FRAME_PERIOD;
+    }
+}
+
+FrameStats Scheduler::stats() const {
+    FrameStats s;
+    s.frames   = frames_;
+    s.overruns = overruns_;
+    if (frames_ > 0) {
+        const double n     = static_cast<double>(frames_);
+        s.mean_jitter_us   = sum_us_ / n;
+        s.max_jitter_us    = max_us_;
+        const double var   = sum_sq_us_ / n - s.mean_jitter_us * s.mean_jitter_us;
+        s.stddev_jitter_us = var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+    return s;
+}
@@ -0,0 +1,83 @@
+#include "../include/thread_pool.hpp"
+
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (std::size_t i = 0; i < threads; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+    for (std::size_t i = 0; i < threads; ++i)
+        threads_.emplace_back(&ThreadPool::worker_loop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (std::thread &thread : threads_)
+        thread.join();
+}
+
+void ThreadPool::submit(Task task) {
+    Worker &worker = *workers_[next_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+    {
+        // Counted before the push, so a worker that takes and finishes the
+        // task straight away never sees the counters trail the deques, and
+        // under the state lock so a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        ++pending_;
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    work_cv_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+}
+
+// Own deque first (newest task, still warm in cache), then steal the oldest
+// task from the next non-empty victim
+bool ThreadPool::try_take(std::size_t self, Task &task) {
+    const std::size_t count = workers_.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        Worker &worker = *workers_[(self + i) % count];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) continue;
+
+        if (i == 0) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        } else {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(std::size_t self) {
+    for (;;) {
+        Task task;
+        if (try_take(self, task)) {
+            task();
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (--pending_ == 0) done_cv_.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        work_cv_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) != 0; });
+        if (stop_ && queued_.load(std::memory_order_acquire) == 0) return;
+    }
+}
@@ -0,0 +1,60 @@
+#include "../include/trace.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+Tracer::Tracer(bool lossless)
+    : ring_(std::make_unique<SpscRing<TraceRecord, RING_RECORDS>>()), lossless_(lossless) {}
+
+bool Tracer::start(const std::string &path, uint64_t rom_hash) {
+    stop();
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    TraceHeader header;
+    header.record_size = sizeof(TraceRecord);
+    header.rom_hash    = rom_hash;
+    if (!file || std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::cerr << "Error: cannot write trace \"" << path << "\".\n";
+        if (file) std::fclose(file);
+        return false;
+    }
+
+    // Leftovers from an earlier session belong to a closed file
+    TraceRecord discard[256];
+    while (ring_->pop(discard, 256) > 0) {}
+
+    dropped_ = 0;
+    written_.store(0, std::memory_order_relaxed);
+    stopping_.store(false, std::memory_order_relaxed);
+    flusher_ = std::thread(&Tracer::flush_loop, this, file);
+    return true;
+}
+
+void Tracer::stop() {
+    if (!flusher_.joinable()) return;
+    stopping_.store(true, std::memory_order_release);
+    flusher_.join();
+}
+
+// Drains the ring in chunks of up to a quarter of its size; naps briefly
+// when it is empty so an idle trace costs no CPU
+void Tracer::flush_loop(std::FILE *file) {
+    std::vector<TraceRecord> chunk(RING_RECORDS / 4);
+    bool ok = true;
+
+    for (;;) {
+        const bool last     = stopping_.load(std::memory_order_acquire); // read before the final drain
+        const std::size_t n = ring_->pop(chunk.data(), chunk.size());
+        if (n > 0) {
+            ok = ok && std::fwrite(chunk.data(), sizeof(TraceRecord), n, file) == n;
+            written_.fetch_add(n, std::memory_order_relaxed);
+            continue;
+        }
+        if (last) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    if (std::fclose(file) != 0) ok = false;
+    if (!ok) std::cerr << "Error: trace file write failed; the trace is incomplete.\n";
+}
@@ -0,0 +1,96 @@
+#include "../include/disasm.hpp"
+#include "../include/trace.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Trace viewer: disassembles a binary execution trace written with --trace
+// (or the F3 hotkey), one instruction per line, with the register it
+// changed and I after it ran.
+
+namespace {
+
+struct ViewOptions {
+    uint64_t from  = 0;          // first seq to print
+    uint64_t count = UINT64_MAX; // records to print
+};
+
+bool parse_view_args(ViewOptions &options, int argc, char **argv) {
+    try {
+        for (int i = 2; i + 1 < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0) continue;
+            const std::string value = argv[++i];
+            if (arg == "--from") options.from = std::stoull(value);
+            else if (arg == "--count") options.count = std::stoull(value);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error parsing arguments: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void print_record(const TraceRecord &r, int return_to) {
+    std::cout << std::setw(10) << std::setfill(' ') << r.seq << "  Address: 0x" << std::hex << std::uppercase
+              << std::setw(3) << std::setfill('0') << r.pc << "  Opcode: 0x" << std::setw(4) << r.opcode
+              << std::dec << "  Desc: ";
+    write_mnemonic(std::cout, r.opcode, return_to);
+
+    std::cout << std::hex << std::uppercase << "  [";
+    if (r.reg < 0xF) std::cout << 'V' << +r.reg << '=' << std::setw(2) << +r.value << ' ';
+    std::cout << "VF=" << std::setw(2) << +r.vf << " I=" << std::setw(3) << r.I << " SP=" << +r.sp << "]\n" << std::dec;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace_path> [--from SEQ] [--count N]\n";
+        return EXIT_FAILURE;
+    }
+
+    ViewOptions options;
+    if (!parse_view_args(options, argc, argv))
+        return EXIT_FAILURE;
+
+    std::ifstream file(argv[1], std::ios::binary);
+    TraceHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != TraceHeader::MAGIC ||
+        header.version != TraceHeader::VERSION || header.record_size != sizeof(TraceRecord)) {
+        std::cerr << "Error: \"" << argv[1] << "\" is not a trace file for this build.\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << "ROM hash: 0x" << std::hex << std::setw(16) << std::setfill('0') << header.rom_hash << std::dec
+              << '\n';
+
+    // One record of lookahead: 00EE returns to the next record's PC
+    TraceRecord current, next;
+    bool have_current = static_cast<bool>(file.read(reinterpret_cast<char *>(&current), sizeof(current)));
+    uint64_t printed = 0, dropped = 0;
+
+    while (have_current && printed < options.count) {
+        const bool have_next = static_cast<bool>(file.read(reinterpret_cast<char *>(&next), sizeof(next)));
+        const bool contiguous = have_next && next.seq == current.seq + 1;
+
+        if (current.seq >= options.from) {
+            print_record(current, contiguous ? next.pc : -1);
+            printed++;
+        }
+        if (have_next && !contiguous) {
+            const uint64_t gap = next.seq - current.seq - 1;
+            std::cout << "            ... " << gap << " records dropped ...\n";
+            dropped += gap;
+        }
+
+        current      = next;
+        have_current = have_next;
+    }
+
+    if (dropped > 0)
+        std::cerr << dropped << " records were dropped while tracing\n";
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,334 @@
+#include "../include/chip8.hpp"
+#include "../include/config.hpp"
+#include "../include/input_script.hpp"
+#include "../include/rewind.hpp"
+#include "../include/run_ahead.hpp"
+#include "../include/savestate.hpp"
+#include "../include/scheduler.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Conformance runner: plays every ROM in test-roms/ for a fixed number of
+// frames, with scripted menu choices and key presses, in each Extension
+// mode, and checks the final framebuffer hash against tests/conformance.golden.
+// One more mode runs XO-CHIP with its quirks overridden to CHIP-8's.
+// The reference run is the interpreter with idle-loop skipping off. Every
+// run is repeated on the interpreter with skipping on, the block engine and
+// the JIT, whose complete machine state must match the reference byte for
+// byte, and once more on the JIT with run-ahead, which must leave no trace
+// on the real timeline. A last run records every frame in a rewind buffer
+// small enough to wrap and steps all the way back through it. Save-state
+// files are checked once, including that corrupt ones are refused.
+//
+//     chip8-conformance [--golden FILE] [--roms DIR] [--update] [--show]
+//
+// --update rewrites the golden file from this build; --show prints the
+// final screen of every run, to check what a new hash stands for.
+
+namespace {
+
+// A key held from `frame` for `held` frames
+struct Press {
+    uint64_t frame;
+    uint8_t key;
+    uint64_t held;
+};
+
+struct Case {
+    const char *name;
+    const char *rom; // relative to --roms
+    uint64_t frames;
+    bool platform_menu; // the ROM asks which platform to test first
+    std::vector<Press> presses;
+};
+
+const std::vector<Case> &cases() {
+    static const std::vector<Case> all = {
+        { "ibm_logo", "IBM Logo.ch8", 60, false, {} },
+        { "test_opcode", "test_opcode.ch8", 120, false, {} },
+        { "bc_test", "BC_test.ch8", 300, false, {} },
+        { "flags", "4-flags.ch8", 300, false, {} },
+        { "quirks", "5-quirks.ch8", 900, true, {} },
+        { "keypad_ex9e", "6-keypad.ch8", 200, false, { { 60, 0x1, 4 }, { 120, 0xA, 80 } } },
+        { "keypad_exa1", "6-keypad.ch8", 200, false, { { 60, 0x2, 4 }, { 120, 0x7, 80 } } },
+        { "keypad_fx0a", "6-keypad.ch8", 135, false, { { 60, 0x3, 4 }, { 120, 0x5, 4 } } },
+    };
+    return all;
+}
+
+// An extension, quirk overrides on top of it, and the platform the quirks
+// test is told it runs on
+struct Mode {
+    const char *name;
+    Extension extension;
+    uint8_t quirks_on, quirks_off;
+    Extension platform;
+};
+
+constexpr Mode MODES[] = {
+    { "chip8", Extension::CHIP8, 0, 0, Extension::CHIP8 },
+    { "superchip", Extension::SUPERCHIP, 0, 0, Extension::SUPERCHIP },
+    { "xochip", Extension::XOCHIP, 0, 0, Extension::XOCHIP },
+    { "xochip-chip8-quirks", Extension::XOCHIP, QUIRK_VF_RESET, QUIRK_WRAP, Extension::CHIP8 },
+};
+constexpr const char *ENGINE_NAMES[]    = { "interpreter", "block", "jit" };
+
+// The platform menu of the Timendus quirks test: 1 CHIP-8, 2 SUPER-CHIP
+// (then 1 for modern), 3 XO-CHIP
+std::vector<Press> platform_presses(Extension extension) {
+    switch (extension) {
+    case Extension::CHIP8: return { { 60, 0x1, 4 } };
+    case Extension::SUPERCHIP: return { { 60, 0x2, 4 }, { 120, 0x1, 4 } };
+    case Extension::XOCHIP: return { { 60, 0x3, 4 } };
+    }
+    return {};
+}
+
+InputScript make_script(const Case &c, Extension extension) {
+    std::vector<Press> presses = c.presses;
+    if (c.platform_menu) {
+        const std::vector<Press> menu = platform_presses(extension);
+        presses.insert(presses.begin(), menu.begin(), menu.end());
+    }
+    InputScript script;
+    for (const Press &press : presses) {
+        script.add({ press.frame, press.key, true });
+        script.add({ press.frame + press.held, press.key, false });
+    }
+    return script;
+}
+
+// Same frame loop as chip8-batch, at the default clock and a fixed seed,
+// optionally speculating `run_ahead` frames after each one like chip8 does
+void run_case(Chip8 &chip8, const Case &c, const Config &config, const InputScript &script,
+              uint32_t run_ahead = 0) {
+    chip8.seed_rng(0);
+    Scheduler scheduler(config.insts_per_second);
+    RunAhead ahead(run_ahead);
+    SaveState snapshot;
+    std::size_t cursor = 0;
+    for (uint64_t frame = 0; frame < c.frames; ++frame) {
+        script.apply(chip8, frame, cursor);
+        chip8.run(config, scheduler.instructions_for_frame());
+        chip8.update_timers();
+        if (ahead.enabled()) {
+            chip8.save_state(snapshot);
+            ahead.speculate(chip8, config, scheduler);
+            ahead.restore(chip8, snapshot);
+        }
+    }
+}
+
+// Replays the case recording each frame in a RewindBuffer too small for the
+// whole run, then steps back through everything it still holds: each state
+// must equal the one recorded that frame and load into the machine as is.
+// Returns what went wrong, if anything.
+std::string check_rewind(Chip8 &chip8, const Case &c, const Config &config, const InputScript &script) {
+    chip8.seed_rng(0);
+    Scheduler scheduler(config.insts_per_second);
+    RewindBuffer rewind(256);
+    std::deque<SaveState> recorded; // the states rewind still holds, oldest first
+    std::size_t cursor = 0;
+    for (uint64_t frame = 0; frame < c.frames; ++frame) {
+        script.apply(chip8, frame, cursor);
+        chip8.run(config, scheduler.instructions_for_frame());
+        chip8.update_timers();
+        recorded.emplace_back();
+        chip8.save_state(recorded.back());
+        rewind.push(recorded.back());
+        while (recorded.size() > rewind.frames()) recorded.pop_front();
+    }
+    if (recorded.size() == c.frames) return "rewind buffer never wrapped";
+
+    SaveState state, reloaded;
+    recorded.pop_back(); // the current state
+    while (rewind.step_back(state)) {
+        if (recorded.empty()) return "rewind stepped back past its oldest state";
+        if (std::memcmp(&state, &recorded.back(), sizeof(SaveState)) != 0) return "rewound state differs";
+        if (!chip8.load_state(state)) return "rewound state refused";
+        chip8.save_state(reloaded);
+        if (std::memcmp(&reloaded, &state, sizeof(SaveState)) != 0) return "rewound state does not reload";
+        recorded.pop_back();
+    }
+    return recorded.empty() ? "" : "rewind lost states it reported";
+}
+
+// Writes `state` to a file and reads it back, then checks that corrupt
+// states are refused by both read_save_state and load_state
+std::string check_state_file(Chip8 &chip8, const SaveState &state) {
+    const std::string path = (std::filesystem::temp_directory_path() / "chip8-conformance.state").string();
+    SaveState loaded;
+    if (!write_save_state(path, state) || !read_save_state(path, loaded)) return "cannot round-trip a state file";
+    if (std::memcmp(&loaded, &state, sizeof(SaveState)) != 0) return "state file reads back different";
+
+    SaveState bad_display = state, bad_sp = state, bad_key = state, bad_bool = state;
+    bad_display.display.resize(64, 4000);
+    bad_sp.sp = 17;
+    bad_key.fx0a_waiting = true;
+    bad_key.fx0a_key     = 16;
+    const uint8_t two    = 2;
+    std::memcpy(&bad_bool.keypad[3], &two, 1);
+
+    std::cerr << "(four corrupt save states follow)\n";
+    for (const SaveState *bad : { &bad_display, &bad_sp, &bad_key, &bad_bool }) {
+        if (!write_save_state(path, *bad)) return "cannot write a state file";
+        if (read_save_state(path, loaded)) return "corrupt state file accepted";
+        if (chip8.load_state(*bad)) return "corrupt state loaded";
+    }
+    std::filesystem::remove(path);
+    return "";
+}
+
+void print_screen(const FrameBuffer &display) {
+    std::array<bool, 128> pixels{};
+    for (std::size_t y = 0; y < display.height(); ++y) {
+        display.unpack_row(y, pixels.data());
+        std::string line(display.width(), '.');
+        for (std::size_t x = 0; x < display.width(); ++x)
+            if (pixels[x]) line[x] = '#';
+        std::cout << "    " << line << '\n';
+    }
+}
+
+// Golden file: `<hash> <case> <mode>` per line; `#` starts a comment
+bool load_golden(const std::string &path, std::map<std::string, uint64_t> &golden) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error: golden file \"" << path << "\" cannot be opened.\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string hash, name, extension;
+        if (!(fields >> hash) || hash[0] == '#' || !(fields >> name >> extension)) continue;
+        golden[name + ' ' + extension] = std::stoull(hash, nullptr, 16);
+    }
+    return true;
+}
+
+bool save_golden(const std::string &path, const std::map<std::string, uint64_t> &results) {
+    std::ofstream file(path, std::ios::trunc);
+    file << "# Final framebuffer hashes for chip8-conformance; regenerate with --update\n"
+         << std::hex << std::setfill('0');
+    for (const auto &[key, hash] : results) file << std::setw(16) << hash << ' ' << key << '\n';
+    if (!file) {
+        std::cerr << "Error: cannot write golden file \"" << path << "\".\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string golden_path = "tests/conformance.golden";
+    std::string rom_dir     = "test-roms";
+    bool update = false, show = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--update") update = true;
+        else if (arg == "--show") show = true;
+        else if (arg == "--golden" && i + 1 < argc) golden_path = argv[++i];
+        else if (arg == "--roms" && i + 1 < argc) rom_dir = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--golden FILE] [--roms DIR] [--update] [--show]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::map<std::string, uint64_t> golden;
+    if (!update && !load_golden(golden_path, golden)) return EXIT_FAILURE;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::map<std::string, uint64_t> results;
+    std::size_t runs = 0, failures = 0;
+    for (const Case &c : cases()) {
+        const std::string rom = (std::filesystem::path(rom_dir) / c.rom).string();
+        for (const Mode &mode : MODES) {
+            Config config;
+            config.current_extension = mode.extension;
+            config.quirks_on         = mode.quirks_on;
+            config.quirks_off        = mode.quirks_off;
+            const InputScript script = make_script(c, mode.platform);
+            const std::string key    = std::string(c.name) + ' ' + mode.name;
+            ++runs;
+
+            // The plain interpreter is the reference; the other engines must
+            // agree with it on everything, not just the screen
+            config.idle_skip = false;
+            Chip8 reference(rom);
+            if (reference.get_state() == EmulatorState::QUIT) {
+                std::cout << "FAIL  " << key << "  (cannot load " << rom << ")\n";
+                ++failures;
+                continue;
+            }
+            run_case(reference, c, config, script);
+            config.idle_skip = true;
+            SaveState expected;
+            reference.save_state(expected);
+            const uint64_t hash = reference.display_hash();
+            results[key]        = hash;
+
+            std::string problem;
+            for (const Engine engine : { Engine::INTERPRETER, Engine::BLOCK, Engine::JIT }) {
+                config.engine = engine;
+                Chip8 chip8(rom);
+                run_case(chip8, c, config, script);
+                SaveState actual;
+                chip8.save_state(actual);
+                if (std::memcmp(&actual, &expected, sizeof(SaveState)) != 0) {
+                    problem = std::string(ENGINE_NAMES[engine]) + " state differs from the reference";
+                    break;
+                }
+            }
+            if (problem.empty()) {
+                Chip8 chip8(rom);
+                run_case(chip8, c, config, script, 2); // config.engine is the JIT here
+                SaveState actual;
+                chip8.save_state(actual);
+                if (std::memcmp(&actual, &expected, sizeof(SaveState)) != 0)
+                    problem = "jit state differs from the reference with run-ahead";
+            }
+            if (problem.empty()) {
+                Chip8 chip8(rom);
+                problem = check_rewind(chip8, c, config, script);
+            }
+            if (problem.empty() && runs == 1) problem = check_state_file(reference, expected);
+            if (problem.empty() && !update) {
+                const auto it = golden.find(key);
+                if (it == golden.end()) problem = "no golden hash";
+                else if (it->second != hash) problem = "hash mismatch";
+            }
+
+            std::ostringstream hex;
+            hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+            if (problem.empty()) {
+                std::cout << "ok    " << hex.str() << ' ' << key << '\n';
+            } else {
+                ++failures;
+                std::cout << "FAIL  " << hex.str() << ' ' << key << "  (" << problem << ")\n";
+            }
+            if (show) print_screen(reference.get_display());
+        }
+    }
+    const double elapsed_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (update && failures == 0 && !save_golden(golden_path, results)) return EXIT_FAILURE;
+    std::cout << runs << " runs, " << failures << " failure(s) in " << std::fixed << std::setprecision(1)
+              << elapsed_ms << " ms" << (update && failures == 0 ? ", golden file updated" : "") << '\n';
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}